@@ -1,13 +1,12 @@
 #ifndef AST_H
 #define AST_H
 
-#include <memory>
-#include <string>
-#include <utility>
-#include <vector>
+#include <cstdint>
+#include <string_view>
+#include "Arena.h"
 
 // Defines the types of nodes that can exist within the Abstract Syntax Tree (AST)
-enum NodeType {
+enum NodeType : std::uint8_t {
     ASSIGN,        // Assignment operation
     PRINT,         // Print operation
     IDENTIFIER,    // Variable identifier
@@ -15,53 +14,17 @@ enum NodeType {
     BINARY_OP      // Binary operation (e.g., addition, subtraction)
 };
 
-// Base class representing a generic node in the AST
-class ASTNode {
-public:
-    NodeType type;  // Type of the AST node
-    std::string value;  // Value associated with the node (e.g., variable name, number)
-    std::vector<std::unique_ptr<ASTNode>> children;  // Children nodes, if any
-
-    /**
-     * Constructor for ASTNode without children
-     *
-     * @param type - the type of the node
-     * @param value - the value associated with the node
-     */
-    ASTNode(const NodeType type, std::string value) : type(type), value(std::move(value)) {}
-
-    /**
-     * Constructor for ASTNode with children
-     *
-     * @param type - the type of the node
-     * @param value - the value associated with the node
-     * @param children - a vector of child nodes
-     */
-    ASTNode(const NodeType type, std::string value, std::vector<std::unique_ptr<ASTNode>> children)
-        : type(type), value(std::move(value)), children(std::move(children)) {}
-
-    // Virtual destructor to ensure proper cleanup in derived classes
-    virtual ~ASTNode() = default;
-};
-
-// Derived class for binary operations in the AST (e.g., addition, subtraction)
-class BinaryOpNode final : public ASTNode {
-public:
-    char op;  // Character representing the operator (e.g., '+', '-')
-
-    /**
-     * Constructs a BinaryOpNode with left and right child nodes
-     *
-     * @param left - left operand node
-     * @param right - right operand node
-     * @param op - character representing the binary operator
-     */
-    BinaryOpNode(std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right, const char op)
-        : ASTNode(BINARY_OP, ""), op(op) {
-        // Initialize children with left and right operand nodes
-        children.push_back(std::move(left));
-        children.push_back(std::move(right));
-    }
+/**
+ * Struct representing a node in the AST.
+ * Nodes, their children and their strings are all allocated in the Arena owned alongside the AST,
+ * so nodes are trivially destructible and a whole tree is freed at once, without recursion.
+ */
+struct ASTNode {
+    NodeType type = ASSIGN;  // Type of the AST node
+    std::string_view value{};  // Value associated with the node (e.g., variable name, number)
+    ArenaSpan<ASTNode*> children{};  // Children nodes, if any (left and right operands for BINARY_OP)
+    char op = '\0';  // Character representing the operator of a BINARY_OP (e.g., '+', '-')
+    int slot = -1;  // Variable slot assigned by the Resolver (identifiers, assignments and prints)
 };
 
 #endif
@@ -0,0 +1,74 @@
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Largest block the arena grows to; bigger requests get a block of their own size
+constexpr std::size_t MAX_BLOCK_SIZE = 64 * 1024 * 1024;
+
+// Constructor records the size of the first block
+Arena::Arena(const std::size_t initialBlockSize) : nextBlockSize(initialBlockSize) {}
+
+/**
+ * Bumps the cursor past an aligned allocation, starting a new block when the current one is full.
+ *
+ * @param size - number of bytes to allocate
+ * @param alignment - required alignment, a power of two
+ * @return pointer to the allocated memory
+ */
+void* Arena::allocate(const std::size_t size, const std::size_t alignment) {
+    auto address = reinterpret_cast<std::uintptr_t>(cursor);
+    auto aligned = (address + alignment - 1) & ~(alignment - 1);
+
+    if (!cursor || aligned + size > reinterpret_cast<std::uintptr_t>(limit)) {
+        grow(size + alignment);
+        address = reinterpret_cast<std::uintptr_t>(cursor);
+        aligned = (address + alignment - 1) & ~(alignment - 1);
+    }
+    cursor = reinterpret_cast<char*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+}
+
+/**
+ * Copies a string into the arena.
+ *
+ * @param text - the characters to copy
+ * @return a view of the copy, valid for the lifetime of the arena
+ */
+std::string_view Arena::copyString(const std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+    auto* copy = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(copy, text.data(), text.size());
+    return {copy, text.size()};
+}
+
+/**
+ * Frees every block except the newest (and largest), and rewinds the cursor to its start.
+ * Repeatedly filling and resetting the arena therefore settles on a single block with no further allocation.
+ */
+void Arena::reset() {
+    if (blocks.empty()) {
+        return;
+    }
+    const std::size_t size = static_cast<std::size_t>(limit - blocks.back().get());
+    std::unique_ptr<char[]> newest = std::move(blocks.back());
+    blocks.clear();
+    blocks.push_back(std::move(newest));
+    cursor = blocks.back().get();
+    limit = cursor + size;
+}
+
+/**
+ * Allocates the next block, doubling the block size each time so a large parse needs few blocks.
+ *
+ * @param minimumSize - the number of bytes the new block must be able to hold
+ */
+void Arena::grow(const std::size_t minimumSize) {
+    const std::size_t size = std::max(nextBlockSize, minimumSize);
+    blocks.emplace_back(new char[size]);
+    cursor = blocks.back().get();
+    limit = cursor + size;
+    nextBlockSize = std::min(nextBlockSize * 2, MAX_BLOCK_SIZE);
+}
@@ -0,0 +1,116 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Struct representing a contiguous run of objects allocated in an Arena.
+ * It does not own its elements; they live as long as the arena that allocated them.
+ */
+template <typename T>
+struct ArenaSpan {
+    T* data = nullptr;       // First element
+    std::size_t count = 0;   // Number of elements
+
+    [[nodiscard]] std::size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    T& operator[](const std::size_t index) const { return data[index]; }
+    T* begin() const { return data; }
+    T* end() const { return data + count; }
+};
+
+/**
+ * Arena class is a bump allocator that owns every object allocated from it.
+ * Allocation is a pointer increment inside large blocks, and everything is released at once when
+ * the arena is destroyed. Only trivially destructible types may be allocated, since no destructors run.
+ */
+class Arena {
+public:
+    /**
+     * Initializes an empty arena. No memory is reserved until the first allocation.
+     *
+     * @param initialBlockSize - size in bytes of the first block; later blocks grow geometrically
+     */
+    explicit Arena(std::size_t initialBlockSize = 64 * 1024);
+
+    Arena(Arena&&) noexcept = default;
+    Arena& operator=(Arena&&) noexcept = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Allocates raw, uninitialized memory.
+     *
+     * @param size - number of bytes to allocate
+     * @param alignment - required alignment, a power of two
+     * @return pointer to the allocated memory
+     */
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    /**
+     * Constructs an object in the arena.
+     *
+     * @param args - arguments forwarded to the constructor
+     * @return pointer to the new object
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+    }
+
+    /**
+     * Allocates a span of value-initialized objects.
+     *
+     * @param count - number of elements
+     * @return the allocated span
+     */
+    template <typename T>
+    ArenaSpan<T> allocateSpan(const std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+        if (count == 0) {
+            return {};
+        }
+        T* data = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+
+        for (std::size_t i = 0; i < count; ++i) {
+            new (data + i) T();
+        }
+        return {data, count};
+    }
+
+    /**
+     * Copies a string into the arena.
+     *
+     * @param text - the characters to copy
+     * @return a view of the copy, valid for the lifetime of the arena
+     */
+    std::string_view copyString(std::string_view text);
+
+    /**
+     * Releases everything allocated so far, keeping the most recent block for reuse.
+     * Every pointer previously returned by the arena becomes invalid.
+     */
+    void reset();
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;  // Every block allocated so far
+    char* cursor = nullptr;                       // Next free byte in the current block
+    char* limit = nullptr;                        // End of the current block
+    std::size_t nextBlockSize;                    // Size of the next block to allocate
+
+    /**
+     * Allocates a new block large enough for the given request and makes it current.
+     *
+     * @param minimumSize - the number of bytes the new block must be able to hold
+     */
+    void grow(std::size_t minimumSize);
+};
+
+#endif // ARENA_H
@@ -0,0 +1,119 @@
+#include "AsmPrinter.h"
+
+namespace {
+    const char* const MNEMONICS[] = {
+        "mov", "add", "sub", "xor", "test", "lea", "neg", "dec", "div", "mul", "shr",
+        "push", "pop", "call", "jns", "jnz", "jz", "jmp", "ret", "syscall"
+    };
+    const char* const REGISTERS_64[] = {
+        "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+        "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"
+    };
+    const char* const REGISTERS_32[] = {
+        "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi",
+        "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d"
+    };
+    const char* const REGISTERS_8[] = {
+        "al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil",
+        "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b"
+    };
+}
+
+// Constructor initializes the printer with a machine program
+AsmPrinter::AsmPrinter(const MachineProgram& program) : program(program) {}
+
+/**
+ * Prints the program: initialized symbols in .data, zeroed ones in .bss, then the instructions in .text.
+ *
+ * @param out - stream receiving the assembly text
+ */
+void AsmPrinter::print(std::ostream& out) const {
+    out << "default rel\n";  // Address all data RIP-relative
+    out << "section .data\n";
+    for (const DataSymbol& symbol : program.symbols) {
+        if (!symbol.initializer.empty()) {
+            out << symbol.name << " db \"" << symbol.initializer << "\"\n";
+        }
+    }
+
+    out << "section .bss\n";
+    for (const DataSymbol& symbol : program.symbols) {
+        if (symbol.initializer.empty()) {
+            out << symbol.name << " resb " << symbol.size << "\n";
+        }
+    }
+
+    out << "section .text\n";
+    out << "global " << program.labels[program.entry] << "\n";
+    for (const MachineInstruction& instruction : program.code) {
+        if (instruction.mnemonic == Mnemonic::LABEL) {
+            out << program.labels[instruction.destination.index] << ":\n";
+            continue;
+        }
+        out << "    " << MNEMONICS[static_cast<int>(instruction.mnemonic)];
+
+        // Memory operands only need a size when no register operand implies it
+        const bool sized = instruction.mnemonic != Mnemonic::LEA && instruction.source.kind != Operand::REGISTER;
+        if (instruction.destination.kind != Operand::NONE) {
+            out << " " << operandText(instruction.destination, instruction.width, sized);
+        }
+        if (instruction.source.kind != Operand::NONE) {
+            out << ", " << operandText(instruction.source, instruction.width, sized);
+        }
+        out << "\n";
+    }
+}
+
+/**
+ * Returns the NASM text of an operand.
+ *
+ * @param operand - the operand to print
+ * @param width - access width in bits
+ * @param sized - whether memory operands get a size prefix
+ * @return the operand text
+ */
+std::string AsmPrinter::operandText(const Operand& operand, const std::uint8_t width, const bool sized) const {
+    std::string prefix;
+
+    if (sized) {
+        prefix = width == 8 ? "byte " : width == 32 ? "dword " : "qword ";
+    }
+    switch (operand.kind) {
+        case Operand::REGISTER:
+            return registerName(operand.reg, width);
+        case Operand::IMMEDIATE:
+            return std::to_string(operand.immediate);
+        case Operand::MEMORY: {
+            std::string text = prefix + "[" + registerName(operand.reg, 64);
+
+            if (operand.displacement > 0) {
+                text += " + " + std::to_string(operand.displacement);
+            } else if (operand.displacement < 0) {
+                text += " - " + std::to_string(-static_cast<std::int64_t>(operand.displacement));
+            }
+            return text + "]";
+        }
+        case Operand::SYMBOL:
+            return prefix + "[" + program.symbols[operand.index].name + "]";
+        case Operand::LABEL:
+            return program.labels[operand.index];
+        default:
+            return "";
+    }
+}
+
+/**
+ * Returns the name of a register at a given width.
+ *
+ * @param reg - the register
+ * @param width - 8, 32 or 64
+ * @return the register name
+ */
+std::string AsmPrinter::registerName(const Register reg, const std::uint8_t width) {
+    const int index = static_cast<int>(reg);
+
+    if (width == 8) {
+        return REGISTERS_8[index];
+    }
+    return width == 32 ? REGISTERS_32[index] : REGISTERS_64[index];
+}
@@ -0,0 +1,51 @@
+#ifndef ASM_PRINTER_H
+#define ASM_PRINTER_H
+
+#include <ostream>
+#include <string>
+#include "MachineCode.h"
+
+/**
+ * The AsmPrinter class writes a MachineProgram as NASM source for `nasm -f elf64`.
+ * Data is addressed RIP-relative, so the listing assembles to the same code the X86Encoder produces.
+ */
+class AsmPrinter {
+public:
+    /**
+     * Initializes the printer with a reference to a machine program.
+     *
+     * @param program - the program to print
+     */
+    explicit AsmPrinter(const MachineProgram& program);
+
+    /**
+     * Prints the .data, .bss and .text sections of the program.
+     *
+     * @param out - stream receiving the assembly text
+     */
+    void print(std::ostream& out) const;
+
+private:
+    /**
+     * Returns the NASM text of an operand.
+     *
+     * @param operand - the operand to print
+     * @param width - access width in bits, selecting register names and memory size prefixes
+     * @param sized - whether memory operands get a size prefix
+     * @return the operand text
+     */
+    [[nodiscard]] std::string operandText(const Operand& operand, std::uint8_t width, bool sized) const;
+
+    /**
+     * Returns the name of a register at a given width.
+     *
+     * @param reg - the register
+     * @param width - 8, 32 or 64
+     * @return the register name
+     */
+    [[nodiscard]] static std::string registerName(Register reg, std::uint8_t width);
+
+    const MachineProgram& program;  // Reference to the program to be printed
+};
+
+#endif // ASM_PRINTER_H
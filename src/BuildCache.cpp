@@ -0,0 +1,121 @@
+#include "BuildCache.h"
+#include "ContentHash.h"
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+#ifndef LITESCRIPT_VERSION
+#define LITESCRIPT_VERSION "unknown"
+#endif
+
+// Constructor initializes the cache over its directory
+BuildCache::BuildCache(std::filesystem::path directory) : directory(std::move(directory)) {}
+
+/**
+ * Returns $XDG_CACHE_HOME/litescript, falling back to ~/.cache/litescript as the XDG specification does.
+ *
+ * @return the directory, or an empty path if neither variable is set
+ */
+std::filesystem::path BuildCache::defaultDirectory() {
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    if (cacheHome != nullptr && *cacheHome != '\0') {
+        return std::filesystem::path(cacheHome) / "litescript";
+    }
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && *home != '\0') {
+        return std::filesystem::path(home) / ".cache" / "litescript";
+    }
+    return {};
+}
+
+/**
+ * Hashes the compiler version, the options and the source, in that order, into 32 hexadecimal digits.
+ *
+ * @param source - the script's source text
+ * @param options - every option that changes the generated code
+ * @return the key
+ */
+std::string BuildCache::key(const std::string_view source, const std::string_view options) {
+    ContentHash hash;
+    hash.add(LITESCRIPT_VERSION);
+    hash.add(options);
+    hash.add(source);
+    return hash.hex();
+}
+
+/**
+ * Copies the stored executable over the given path, and the stored assembly if requested. A missing or
+ * unreadable entry is a miss.
+ *
+ * @param key - the build's key
+ * @param filename - path of the executable to create
+ * @param withAsm - whether filename + ".asm" must be restored as well
+ * @return true if the entry was found and copied
+ */
+bool BuildCache::fetch(const std::string& key, const std::string& filename, const bool withAsm) const {
+    namespace fs = std::filesystem;
+    const fs::path executable = directory / key;
+    const fs::path assembly = directory / (key + ".asm");
+    std::error_code error;
+
+    if (!fs::is_regular_file(executable, error) || (withAsm && !fs::is_regular_file(assembly, error))) {
+        return false;
+    }
+    if (withAsm && !fs::copy_file(assembly, filename + ".asm", fs::copy_options::overwrite_existing, error)) {
+        return false;
+    }
+    // The executable is a copy, never a link, since the next uncached build rewrites it in place
+    fs::remove(filename, error);
+    if (!fs::copy_file(executable, filename, error)) {
+        return false;
+    }
+    fs::permissions(filename, fs::perms::owner_all | fs::perms::group_read | fs::perms::group_exec
+                              | fs::perms::others_read | fs::perms::others_exec, error);
+    return !error;
+}
+
+/**
+ * Stores the assembly before the executable, so an entry whose executable is present is always complete for
+ * builds that did not ask for assembly.
+ *
+ * @param key - the build's key
+ * @param filename - path of the executable
+ * @param withAsm - whether filename + ".asm" exists and should be stored too
+ */
+void BuildCache::store(const std::string& key, const std::string& filename, const bool withAsm) const {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        return;
+    }
+    if (withAsm && !storeFile(filename + ".asm", directory / (key + ".asm"))) {
+        return;
+    }
+    storeFile(filename, directory / key);
+}
+
+/**
+ * Copies a file to a uniquely named temporary entry and renames it over the final one, which replaces it
+ * atomically even if another compiler is storing the same build.
+ *
+ * @param source - the file to store
+ * @param entry - the entry's final path
+ * @return true if the entry was stored
+ */
+bool BuildCache::storeFile(const std::filesystem::path& source, const std::filesystem::path& entry) {
+    std::random_device random;
+    std::filesystem::path temporary = entry;
+    temporary += ".tmp" + std::to_string(random()) + std::to_string(random());
+    std::error_code error;
+
+    if (!std::filesystem::copy_file(source, temporary, error)) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    std::filesystem::rename(temporary, entry, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
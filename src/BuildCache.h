@@ -0,0 +1,75 @@
+#ifndef BUILD_CACHE_H
+#define BUILD_CACHE_H
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+/**
+ * BuildCache class keeps compiled executables in a local directory, addressed by the content of the script and
+ * the options that shaped the code, so compiling an unchanged script again skips parsing, code generation and
+ * encoding and only copies the stored executable.
+ *
+ * Entries are written under a temporary name and renamed into place, so concurrent compilers never see a
+ * partial entry. The cache only ever saves work: an entry that cannot be read is a miss, and one that cannot be
+ * stored is skipped.
+ */
+class BuildCache {
+public:
+    /**
+     * Initializes the cache over a directory, which is created when the first entry is stored.
+     *
+     * @param directory - the directory holding the entries
+     */
+    explicit BuildCache(std::filesystem::path directory);
+
+    /**
+     * Returns the default cache directory: litescript under $XDG_CACHE_HOME, or under ~/.cache without it.
+     *
+     * @return the directory, or an empty path if neither variable is set
+     */
+    static std::filesystem::path defaultDirectory();
+
+    /**
+     * Computes the key of a build: a 128-bit hash, in hexadecimal, of the compiler version, the options and the
+     * source text.
+     *
+     * @param source - the script's source text
+     * @param options - every option that changes the generated code
+     * @return the key
+     */
+    static std::string key(std::string_view source, std::string_view options);
+
+    /**
+     * Copies a stored executable, and its assembly if requested, to the given path.
+     *
+     * @param key - the build's key
+     * @param filename - path of the executable to create
+     * @param withAsm - whether filename + ".asm" must be restored as well
+     * @return true if the entry was found and copied
+     */
+    bool fetch(const std::string& key, const std::string& filename, bool withAsm) const;
+
+    /**
+     * Stores a freshly built executable, and its assembly if it was written.
+     *
+     * @param key - the build's key
+     * @param filename - path of the executable
+     * @param withAsm - whether filename + ".asm" exists and should be stored too
+     */
+    void store(const std::string& key, const std::string& filename, bool withAsm) const;
+
+private:
+    /**
+     * Copies a file into the cache under a temporary name, then renames it into place.
+     *
+     * @param source - the file to store
+     * @param entry - the entry's final path
+     * @return true if the entry was stored
+     */
+    static bool storeFile(const std::filesystem::path& source, const std::filesystem::path& entry);
+
+    std::filesystem::path directory;  // Directory holding the entries
+};
+
+#endif // BUILD_CACHE_H
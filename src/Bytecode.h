@@ -0,0 +1,59 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Value.h"
+
+/**
+ * Enum class representing the instructions understood by the VM.
+ * Every instruction works on the VM's operand stack.
+ */
+enum class OpCode : std::uint8_t {
+    LOAD_CONST,  // Push constants[operand]
+    LOAD_SLOT,   // Push slots[operand]
+    ADD,         // Pop two values and push their sum
+    SUB,         // Pop two values and push their difference
+    STORE,       // Pop a value into slots[operand]
+    SHOW,        // Print slots[operand]
+    HALT         // Stop execution
+};
+
+/**
+ * Struct representing a single bytecode instruction with its operand (a constant or slot index).
+ */
+struct Instruction {
+    OpCode op;
+    std::uint32_t operand;
+};
+
+/**
+ * Struct referencing what the VM needs of a compiled program without owning it, so a Chunk built in memory and
+ * a bytecode file mapped from disk run the same way.
+ */
+struct ChunkView {
+    const Instruction* code = nullptr;    // Instructions, terminated by HALT
+    const Value* constants = nullptr;     // Constant pool for LOAD_CONST
+    std::size_t slotCount = 0;            // Number of variable slots
+    std::size_t maxStack = 0;             // Deepest operand stack the code can reach
+};
+
+/**
+ * Struct representing a compiled program: a linear instruction stream plus the tables it refers to.
+ */
+struct Chunk {
+    std::vector<Instruction> code;        // Instructions, terminated by HALT
+    std::vector<Value> constants;         // Constant pool for LOAD_CONST
+    std::vector<std::string> slotNames;   // Variable name for each slot
+    std::size_t maxStack = 0;             // Deepest operand stack the code can reach
+
+    /**
+     * Returns a view of the chunk for the VM, valid while the chunk is unchanged.
+     *
+     * @return the view
+     */
+    [[nodiscard]] ChunkView view() const { return {code.data(), constants.data(), slotNames.size(), maxStack}; }
+};
+
+#endif // BYTECODE_H
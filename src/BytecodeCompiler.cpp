@@ -0,0 +1,63 @@
+#include "BytecodeCompiler.h"
+#include <algorithm>
+
+// Constructor initializes the bytecode compiler with a flat program
+BytecodeCompiler::BytecodeCompiler(const FlatProgram& program) : program(program) {}
+
+/**
+ * Compiles every node of the program into the chunk, terminated by a HALT instruction.
+ * The constant pool and slot table are shared with the program unchanged.
+ *
+ * @return the compiled chunk
+ */
+Chunk BytecodeCompiler::compile() {
+    chunk.constants = program.constants;
+    chunk.slotNames = program.slotNames;
+    chunk.code.reserve(program.size() + 1);
+
+    for (std::uint32_t i = 0; i < program.size(); ++i) {
+        switch (program.kinds[i]) {
+            case NUMBER:
+                emit(OpCode::LOAD_CONST, program.operands[i]);
+                break;
+            case IDENTIFIER:
+                emit(OpCode::LOAD_SLOT, program.operands[i]);
+                break;
+            case BINARY_OP:
+                emit(program.ops[i] == '+' ? OpCode::ADD : OpCode::SUB);
+                break;
+            case ASSIGN:
+                emit(OpCode::STORE, program.operands[i]);
+                break;
+            case PRINT:
+                emit(OpCode::SHOW, program.operands[i]);
+                break;
+        }
+    }
+    emit(OpCode::HALT);
+    return std::move(chunk);
+}
+
+/**
+ * Appends an instruction to the chunk and records the maximum operand stack depth.
+ *
+ * @param op - the opcode to emit
+ * @param operand - the instruction operand, if any
+ */
+void BytecodeCompiler::emit(const OpCode op, const std::uint32_t operand) {
+    chunk.code.push_back({op, operand});
+
+    switch (op) {
+        case OpCode::LOAD_CONST:
+        case OpCode::LOAD_SLOT:
+            chunk.maxStack = std::max(chunk.maxStack, ++depth);
+            break;
+        case OpCode::ADD:
+        case OpCode::SUB:
+        case OpCode::STORE:
+            --depth;
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef BYTECODE_COMPILER_H
+#define BYTECODE_COMPILER_H
+
+#include "Bytecode.h"
+#include "FlatProgram.h"
+
+/**
+ * The BytecodeCompiler class lowers a FlatProgram into a linear bytecode Chunk for the VM.
+ * The program's nodes are already in post-order, so each node maps to exactly one stack instruction.
+ */
+class BytecodeCompiler {
+public:
+    /**
+     * Initializes the bytecode compiler with a reference to a flat program.
+     *
+     * @param program - the program to be compiled
+     */
+    explicit BytecodeCompiler(const FlatProgram& program);
+
+    /**
+     * Compiles the program into a chunk of bytecode.
+     *
+     * @return the compiled chunk
+     */
+    Chunk compile();
+
+private:
+    const FlatProgram& program;  // Reference to the program to be compiled
+    Chunk chunk;                 // Chunk being built
+    std::size_t depth = 0;       // Current operand stack depth
+
+    /**
+     * Appends an instruction to the chunk and tracks the resulting stack depth.
+     *
+     * @param op - the opcode to emit
+     * @param operand - the instruction operand, if any
+     */
+    void emit(OpCode op, std::uint32_t operand = 0);
+};
+
+#endif // BYTECODE_COMPILER_H
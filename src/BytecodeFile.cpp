@@ -0,0 +1,162 @@
+#include "BytecodeFile.h"
+#include "ContentHash.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// The instruction stream is written byte for byte as the VM reads it
+static_assert(sizeof(Instruction) == 8 && offsetof(Instruction, operand) == 4, "Unexpected instruction layout");
+
+/**
+ * Maps the file, then checks the magic number, the version, that the sections exactly fill the file, that the
+ * stream ends in HALT, the checksum, and finally that the code is safe to run: the VM trusts every operand and
+ * count, and a file may have been written by anyone. The sections follow the 8-byte header fields in order, so
+ * each is aligned within the page-aligned mapping.
+ *
+ * @param filename - the name of the .lsc file
+ */
+BytecodeFile::BytecodeFile(const std::string& filename) : file(filename) {
+    const std::string_view bytes = file.view();
+    Header header{};
+
+    if (bytes.size() < sizeof(Header)) {
+        throw std::runtime_error("Not a bytecode file: " + filename);
+    }
+    std::memcpy(&header, bytes.data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a bytecode file: " + filename);
+    }
+    if (header.version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported bytecode version " + std::to_string(header.version) + " in " + filename
+                                 + "; rebuild it from its source");
+    }
+
+    // Compare counts against the payload before multiplying them, so a corrupt count cannot overflow
+    const std::string_view payload = bytes.substr(sizeof(Header));
+    const std::size_t words = payload.size() / 8;
+    if (header.codeSize == 0 || header.codeSize > words || header.constantCount > words - header.codeSize
+        || header.namesSize != payload.size() - (header.codeSize + header.constantCount) * 8
+        || header.maxStack > header.codeSize) {
+        throw std::runtime_error("Corrupt bytecode file: " + filename);
+    }
+    const auto* code = reinterpret_cast<const Instruction*>(payload.data());
+    if (code[header.codeSize - 1].op != OpCode::HALT) {
+        throw std::runtime_error("Corrupt bytecode file: " + filename);
+    }
+
+    ContentHash checksum;
+    checksum.add(payload);
+    if (checksum.value() != header.checksum) {
+        throw std::runtime_error("Corrupt bytecode file: " + filename + " (checksum mismatch)");
+    }
+
+    const std::string_view names = payload.substr((header.codeSize + header.constantCount) * 8);
+    if (!validCode(header, code) || (!names.empty() && names.back() != '\0')
+        || static_cast<std::uint64_t>(std::count(names.begin(), names.end(), '\0')) != header.slotCount) {
+        throw std::runtime_error("Corrupt bytecode file: " + filename);
+    }
+
+    view.code = code;
+    view.constants = reinterpret_cast<const Value*>(payload.data() + header.codeSize * 8);
+    view.slotCount = static_cast<std::size_t>(header.slotCount);
+    view.maxStack = static_cast<std::size_t>(header.maxStack);
+}
+
+/**
+ * Walks the instruction stream once, checking every opcode and operand against the header and simulating the
+ * operand stack. The stream has no jumps, so the simulated depth is the depth every run reaches.
+ *
+ * @param header - the file's header
+ * @param code - the instruction stream, codeSize instructions long
+ * @return true if the VM can run the stream without reading or writing outside its tables
+ */
+bool BytecodeFile::validCode(const Header& header, const Instruction* code) {
+    std::uint64_t depth = 0;
+
+    for (std::uint64_t i = 0; i < header.codeSize; ++i) {
+        const Instruction& instruction = code[i];
+
+        switch (instruction.op) {
+            case OpCode::LOAD_CONST:
+            case OpCode::LOAD_SLOT:
+                if (instruction.operand >= (instruction.op == OpCode::LOAD_CONST ? header.constantCount
+                                                                                 : header.slotCount)
+                    || ++depth > header.maxStack) {
+                    return false;
+                }
+                break;
+            case OpCode::ADD:
+            case OpCode::SUB:
+                if (depth < 2) {
+                    return false;
+                }
+                --depth;
+                break;
+            case OpCode::STORE:
+                if (instruction.operand >= header.slotCount || depth < 1) {
+                    return false;
+                }
+                --depth;
+                break;
+            case OpCode::SHOW:
+                if (instruction.operand >= header.slotCount) {
+                    return false;
+                }
+                break;
+            case OpCode::HALT:
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Lays out the sections in one buffer, with the unused bytes of every instruction zeroed, so the same chunk
+ * always produces the same file; then checksums the buffer and writes the header before it.
+ *
+ * @param chunk - the chunk to write
+ * @param filename - the name of the .lsc file
+ */
+void BytecodeFile::write(const Chunk& chunk, const std::string& filename) {
+    std::string payload(chunk.code.size() * 8 + chunk.constants.size() * 8, '\0');
+    char* out = payload.data();
+
+    for (const Instruction& instruction : chunk.code) {
+        std::memcpy(out, &instruction.op, sizeof(instruction.op));
+        std::memcpy(out + offsetof(Instruction, operand), &instruction.operand, sizeof(instruction.operand));
+        out += 8;
+    }
+    if (!chunk.constants.empty()) {
+        std::memcpy(out, chunk.constants.data(), chunk.constants.size() * 8);
+    }
+    for (const std::string& name : chunk.slotNames) {
+        payload += name;
+        payload += '\0';
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.codeSize = chunk.code.size();
+    header.constantCount = chunk.constants.size();
+    header.slotCount = chunk.slotNames.size();
+    header.maxStack = chunk.maxStack;
+    header.namesSize = payload.size() - (header.codeSize + header.constantCount) * 8;
+    ContentHash checksum;
+    checksum.add(payload);
+    header.checksum = checksum.value();
+
+    std::ofstream outFile(filename, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        throw std::runtime_error("Could not open file for writing: " + filename);
+    }
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    outFile.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    if (!outFile) {
+        throw std::runtime_error("Could not write file: " + filename);
+    }
+}
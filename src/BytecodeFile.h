@@ -0,0 +1,77 @@
+#ifndef BYTECODE_FILE_H
+#define BYTECODE_FILE_H
+
+#include <cstdint>
+#include <string>
+#include "Bytecode.h"
+#include "SourceFile.h"
+
+/**
+ * BytecodeFile class reads and writes compiled programs as .lsc files, so a script can be lexed, parsed and
+ * optimized once and then run any number of times.
+ *
+ * A file is a fixed header followed by the instruction stream, the constant pool and the slot table, each laid
+ * out exactly as the VM reads it in memory. Loading maps the file with a single mmap and points the VM straight
+ * into the mapping; nothing is decoded or copied. The header records a format version and a checksum of the
+ * rest of the file, which are checked before anything runs. Files use the byte order and layout of the machine
+ * that wrote them.
+ */
+class BytecodeFile {
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 1;  // Bumped whenever the layout or the instruction set changes
+
+    /**
+     * Maps a bytecode file and checks its header and checksum.
+     * Throws if the file cannot be read, is not a bytecode file, has another version, or is corrupt, including
+     * code that would reach outside its constants, slots or stack.
+     *
+     * @param filename - the name of the .lsc file
+     */
+    explicit BytecodeFile(const std::string& filename);
+
+    /**
+     * Returns the program stored in the file, valid for the lifetime of this object.
+     *
+     * @return a view of the mapped program
+     */
+    [[nodiscard]] const ChunkView& chunk() const { return view; }
+
+    /**
+     * Writes a compiled chunk as a bytecode file. Throws if the file cannot be written.
+     *
+     * @param chunk - the chunk to write
+     * @param filename - the name of the .lsc file
+     */
+    static void write(const Chunk& chunk, const std::string& filename);
+
+private:
+    /**
+     * Struct representing the header at the start of every bytecode file.
+     */
+    struct Header {
+        char magic[4];                // MAGIC
+        std::uint32_t version;        // FORMAT_VERSION of the writer
+        std::uint64_t checksum;       // ContentHash value of every byte after the header
+        std::uint64_t codeSize;       // Instructions in the stream, including the final HALT
+        std::uint64_t constantCount;  // Values in the constant pool
+        std::uint64_t slotCount;      // Variable slots
+        std::uint64_t maxStack;       // Deepest operand stack the code can reach
+        std::uint64_t namesSize;      // Bytes of slot names, each terminated by a NUL
+    };
+
+    /**
+     * Checks that every instruction is valid and stays within the tables and stack the header declares.
+     *
+     * @param header - the file's header
+     * @param code - the instruction stream
+     * @return true if the stream is safe to run
+     */
+    static bool validCode(const Header& header, const Instruction* code);
+
+    static constexpr char MAGIC[4] = {'L', 'S', 'C', '\0'};  // Identifies a bytecode file
+
+    SourceFile file;  // The mapped file
+    ChunkView view;   // The program, pointing into the mapping
+};
+
+#endif // BYTECODE_FILE_H
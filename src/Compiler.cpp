@@ -1,164 +1,480 @@
 #include "Compiler.h"
-#include "AST.h"
+#include "AsmPrinter.h"
+#include "ElfWriter.h"
+#include "RegisterAllocator.h"
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #include <iostream>
-#include <memory>
-#include <cctype>
+#include <vector>
+#include <cstdint>
+#include <iterator>
 
-// Constructor initializes the compiler with a vector of AST nodes
-Compiler::Compiler(const std::vector<std::unique_ptr<ASTNode>>& nodes) : ast(nodes) {}
+// Registers handed out to variables in executables: everything print_value and flush_output leave intact
+const Register Compiler::EXECUTABLE_REGISTERS[] = {
+    Register::RBX, Register::RBP, Register::R9, Register::R10,
+    Register::R12, Register::R13, Register::R14, Register::R15
+};
+
+// Registers handed out to variables in functions: the callee-saved ones the print function preserves, less SLOT_BASE
+const Register Compiler::FUNCTION_REGISTERS[] = {
+    Register::RBX, Register::RBP, Register::R12, Register::R13, Register::R14
+};
+
+namespace {
+    const Operand RAX = Operand::ofRegister(Register::RAX);
+    const Operand RCX = Operand::ofRegister(Register::RCX);
+    const Operand RDX = Operand::ofRegister(Register::RDX);
+    const Operand RSI = Operand::ofRegister(Register::RSI);
+    const Operand RDI = Operand::ofRegister(Register::RDI);
+    const Operand RSP = Operand::ofRegister(Register::RSP);
+    const Operand R8 = Operand::ofRegister(Register::R8);
+
+    // Registers summing the terms of an expression, free for scratch use in both targets; the result ends in rax
+    const Register ACCUMULATORS[] = {Register::RAX, Register::RDX, Register::RSI, Register::RDI};
+    constexpr std::size_t TERMS_PER_ACCUMULATOR = 4;  // Fewer terms than this do not pay for another accumulator
+}
+
+// Constructor initializes the compiler with a flat program
+Compiler::Compiler(const FlatProgram& program) : program(program) {}
 
 /**
- * Compiles the AST into assembly code and saves it to a file.
+ * Generates the machine program: allocates registers to variables, declares the data, and generates the
+ * output routines followed by the code of every statement.
  *
- * Generates .data, .bss, and .text sections and then runs the generated code.
- * @param filename - name of the file to write assembly code
+ * @return the generated machine program
  */
-void Compiler::compile(const std::string& filename) const {
-    std::ofstream outFile(filename);
+MachineProgram Compiler::generate() {
+    machine = MachineProgram();
+    target = Target::EXECUTABLE;
 
-    if (!outFile.is_open()) {
-        throw std::runtime_error("Could not open file for writing: " + filename);
-    }
-    generateDataSection(outFile);   // Generate .data section for static data
-    generateBssSection(outFile);    // Generate .bss section for variable storage
-    generateTextSection(outFile);   // Generate .text section for main instructions
-    compileAndRun();                   // Assemble, link, and execute the program
+    generateData();      // Declare static data and variable storage
+    generateRuntime();   // Routine shared by every print
+
+    machine.entry = createLabel("_start");
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(machine.entry));
+    generateStatements(false);
+    generateExit();  // Append code for program exit
+    return std::move(machine);
 }
 
 /**
- * Generates the .data section, including static data like the output format for printf.
+ * Generates the machine program as a function called by the JIT with the host's slot array.
  *
- * @param outFile - output file stream to write the .data section
+ * @param printFunction - address of the host function that prints a value
+ * @param printContext - pointer passed back to the print function with every value
+ * @return the generated machine program
  */
-void Compiler::generateDataSection(std::ofstream& outFile) const {
-    outFile << "section .data\n";
-    outFile << "output_format db \"Result: %d\", 0\n";  // Defines format string for printing results
+MachineProgram Compiler::generateFunction(const std::uint64_t printFunction, const std::uint64_t printContext) {
+    machine = MachineProgram();
+    target = Target::FUNCTION;
+    this->printFunction = printFunction;
+    this->printContext = printContext;
+
+    machine.entry = createLabel("run");
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(machine.entry));
+    generatePrologue();
+    generateEpilogue(generateStatements(true));
+    return std::move(machine);
 }
 
 /**
- * Generates the .bss section, reserving memory for variables used in the program.
+ * Allocates registers for the current target and generates the code of each statement in the program.
  *
- * @param outFile - output file stream to write the .bss section
+ * @param liveAtExit - whether every variable's final value must be available after the last statement
+ * @return the location of each slot's final value
  */
-void Compiler::generateBssSection(std::ofstream& outFile) const {
-    outFile << "section .bss\n";
+std::vector<std::int8_t> Compiler::generateStatements(const bool liveAtExit) {
+    const std::uint8_t registerCount = target == Target::FUNCTION ? FUNCTION_REGISTER_COUNT : EXECUTABLE_REGISTER_COUNT;
+    RegisterAllocator allocator(program, registerCount, liveAtExit);
 
-    // Reserve space for each variable involved in assignment
-    for (const auto& node : ast) {
-        if (node->type == ASSIGN) {
-            outFile << node->value << " resd 1\n";  // Reserve 4 bytes per variable
+    locations = allocator.allocate();
+    for (const std::uint32_t node : program.statements) {
+        if (program.kinds[node] == ASSIGN) {
+            generateAssignment(node);
+        } else if (program.kinds[node] == PRINT) {
+            generatePrint(node);
         }
     }
+    return allocator.exitLocations();
 }
 
 /**
- * Generates the .text section with main program instructions.
- *
- * @param outFile - output file stream for the .text section
+ * Generates the function prologue. Six pushes after the return address leave the stack 8 bytes off the 16-byte
+ * alignment the System V ABI requires at calls, so 8 more bytes are reserved.
  */
-void Compiler::generateTextSection(std::ofstream& outFile) const {
-    outFile << "section .text\n";
-    outFile << "extern printf\n";
-    outFile << "global _start\n";
-    outFile << "_start:\n";
+void Compiler::generatePrologue() {
+    for (const Register reg : FUNCTION_REGISTERS) {
+        emit(Mnemonic::PUSH, 64, Operand::ofRegister(reg));
+    }
+    emit(Mnemonic::PUSH, 64, Operand::ofRegister(SLOT_BASE));
+    emit(Mnemonic::SUB, 64, RSP, Operand::ofImmediate(8));
+    emit(Mnemonic::MOV, 64, Operand::ofRegister(SLOT_BASE), RDI);  // First argument: the slot array
+}
 
-    // Generate code for each node in the AST
-    for (const auto& node : ast) {
-        if (node->type == ASSIGN) {
-            generateAssignment(outFile, node);
-        } else if (node->type == PRINT) {
-            generatePrint(outFile, node);
+/**
+ * Generates the function epilogue, writing back every final value that lives in a register.
+ *
+ * @param exitLocations - location of each slot's final value
+ */
+void Compiler::generateEpilogue(const std::vector<std::int8_t>& exitLocations) {
+    for (std::size_t slot = 0; slot < exitLocations.size(); ++slot) {
+        if (exitLocations[slot] >= 0) {
+            emit(Mnemonic::MOV, 64, Operand::ofMemory(SLOT_BASE, static_cast<std::int32_t>(slot * sizeof(Value))),
+                 Operand::ofRegister(FUNCTION_REGISTERS[exitLocations[slot]]));
         }
     }
-    generateExit(outFile);  // Append code for program exit
+    emit(Mnemonic::ADD, 64, RSP, Operand::ofImmediate(8));
+    emit(Mnemonic::POP, 64, Operand::ofRegister(SLOT_BASE));
+    for (auto it = std::rbegin(FUNCTION_REGISTERS); it != std::rend(FUNCTION_REGISTERS); ++it) {
+        emit(Mnemonic::POP, 64, Operand::ofRegister(*it));
+    }
+    emit(Mnemonic::RET, 0);
+}
+
+/**
+ * Compiles the program into an executable and runs it.
+ *
+ * @param filename - path of the executable to create
+ * @param emitAsm - whether to also write the NASM source to filename + ".asm"
+ */
+void Compiler::compile(const std::string& filename, const bool emitAsm) {
+    build(filename, emitAsm);
+    run(filename);  // Execute the program
 }
 
 /**
- * Generates assembly code for assignment operations.
- * Supports binary operations and direct assignments of literals/identifiers.
+ * Compiles the program into an executable.
  *
- * @param outFile - output file stream for assembly code
- * @param node - AST node representing an assignment
+ * The machine code is encoded in-process and written as a static ELF64 executable, so no assembler or linker
+ * is needed. The NASM listing of the same code can be written next to it for inspection.
+ * @param filename - path of the executable to create
+ * @param emitAsm - whether to also write the NASM source to filename + ".asm"
  */
-void Compiler::generateAssignment(std::ofstream& outFile, const std::unique_ptr<ASTNode>& node) const {
-    if (node->children[0]->type == BINARY_OP) {
-        const auto* binOpNode = dynamic_cast<const BinaryOpNode*>(node->children[0].get());
+void Compiler::build(const std::string& filename, const bool emitAsm) {
+    const MachineProgram machineProgram = generate();
+
+    if (emitAsm) {
+        std::ofstream outFile(filename + ".asm");
 
-        if (!binOpNode || binOpNode->children.size() < 2) {
-            std::cerr << "Error: Invalid BinaryOpNode in assignment.\n";
-            return;
+        if (!outFile.is_open()) {
+            throw std::runtime_error("Could not open file for writing: " + filename + ".asm");
         }
-        // Generate binary operation code
-        outFile << "    mov eax, dword [" << binOpNode->children[0]->value << "]\n";
+        AsmPrinter(machineProgram).print(outFile);
+    }
+    ElfWriter(machineProgram).write(filename);  // Encode and write the executable
+}
+
+/**
+ * Declares the output prefix, the zeroed output buffer with its fill level, and zeroed storage for every
+ * variable slot.
+ */
+void Compiler::generateData() {
+    machine.symbols.push_back({"result_prefix", "Result: ", 8});  // Exactly 8 bytes, copied into the output as one qword
+    machine.symbols.push_back({"output_buffer", "", OUTPUT_CAPACITY});
+    machine.symbols.push_back({"output_used", "", 8});
+
+    for (const std::string& name : program.slotNames) {
+        // The prefix keeps script names from colliding with register names and NASM keywords
+        machine.symbols.push_back({"var_" + name, "", 8});
+    }
+}
+
+/**
+ * Generates the print_value routine, which appends "Result: <rax>\n" to the output buffer. Digits are produced
+ * backwards into a buffer on the stack; the magnitude is divided as an unsigned value so the most negative
+ * integer prints correctly. Each division by 10 is a multiplication by its fixed-point reciprocal, and the line
+ * is copied into the output buffer with four quadword moves, so the only branches are the digit loop, the sign,
+ * and the check for a full buffer. A buffer with no room for another line is written out by tail-jumping to
+ * flush_output.
+ */
+void Compiler::generateRuntime() {
+    printLabel = createLabel("print_value");
+    flushLabel = createLabel("flush_output");
+    const std::uint32_t digits = createLabel(".digits");
+    const std::uint32_t prefix = createLabel(".prefix");
+    const Operand R11 = Operand::ofRegister(Register::R11);
+
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(printLabel));
+    emit(Mnemonic::SUB, 64, RSP, Operand::ofImmediate(40));                 // Room for the prefix, sign, 20 digits, and newline
+    emit(Mnemonic::LEA, 64, RSI, Operand::ofMemory(Register::RSP, 39));
+    emit(Mnemonic::MOV, 8, Operand::ofMemory(Register::RSI), Operand::ofImmediate('\n'));
+    emit(Mnemonic::MOV, 64, R8, RAX);                                       // Remember the sign
+    emit(Mnemonic::MOV, 64, RDI, Operand::ofImmediate(static_cast<std::int64_t>(0xCCCCCCCCCCCCCCCDull)));  // 2^67 / 10, rounded up
+    emit(Mnemonic::TEST, 64, RAX, RAX);
+    emit(Mnemonic::JNS, 0, Operand::ofLabel(digits));
+    emit(Mnemonic::NEG, 64, RAX);
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(digits));
+    emit(Mnemonic::MOV, 64, RCX, RAX);
+    emit(Mnemonic::MUL, 64, RDI);
+    emit(Mnemonic::SHR, 64, RDX, Operand::ofImmediate(3));                  // Quotient by 10
+    emit(Mnemonic::MOV, 64, RAX, RDX);
+    emit(Mnemonic::ADD, 64, RDX, RDX);
+    emit(Mnemonic::MOV, 64, R11, RDX);
+    emit(Mnemonic::ADD, 64, RDX, RDX);
+    emit(Mnemonic::ADD, 64, RDX, RDX);
+    emit(Mnemonic::ADD, 64, RDX, R11);                                      // Ten times the quotient
+    emit(Mnemonic::SUB, 64, RCX, RDX);                                      // Remainder: the next digit
+    emit(Mnemonic::ADD, 8, RCX, Operand::ofImmediate('0'));
+    emit(Mnemonic::DEC, 64, RSI);
+    emit(Mnemonic::MOV, 8, Operand::ofMemory(Register::RSI), RCX);
+    emit(Mnemonic::TEST, 64, RAX, RAX);
+    emit(Mnemonic::JNZ, 0, Operand::ofLabel(digits));
+    emit(Mnemonic::TEST, 64, R8, R8);
+    emit(Mnemonic::JNS, 0, Operand::ofLabel(prefix));
+    emit(Mnemonic::DEC, 64, RSI);
+    emit(Mnemonic::MOV, 8, Operand::ofMemory(Register::RSI), Operand::ofImmediate('-'));
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(prefix));
+    emit(Mnemonic::SUB, 64, RSI, Operand::ofImmediate(8));
+    emit(Mnemonic::MOV, 64, RAX, Operand::ofSymbol(PREFIX_SYMBOL));
+    emit(Mnemonic::MOV, 64, Operand::ofMemory(Register::RSI), RAX);
+    emit(Mnemonic::LEA, 64, RDX, Operand::ofMemory(Register::RSP, 40));
+    emit(Mnemonic::SUB, 64, RDX, RSI);                                      // Length of the formatted line
+    emit(Mnemonic::MOV, 64, RCX, Operand::ofSymbol(OUTPUT_USED_SYMBOL));
+    emit(Mnemonic::LEA, 64, RDI, Operand::ofSymbol(OUTPUT_SYMBOL));
+    emit(Mnemonic::ADD, 64, RDI, RCX);                                      // End of the buffered output
+
+    // Copy a fixed 32 bytes: the line and whatever follows it on the stack, which the next line overwrites
+    for (std::int32_t offset = 0; offset < OUTPUT_LINE_COPY; offset += 8) {
+        emit(Mnemonic::MOV, 64, RAX, Operand::ofMemory(Register::RSI, offset));
+        emit(Mnemonic::MOV, 64, Operand::ofMemory(Register::RDI, offset), RAX);
+    }
+    emit(Mnemonic::ADD, 64, RCX, RDX);
+    emit(Mnemonic::MOV, 64, Operand::ofSymbol(OUTPUT_USED_SYMBOL), RCX);
+    emit(Mnemonic::ADD, 64, RSP, Operand::ofImmediate(40));
+    emit(Mnemonic::SUB, 64, RCX, Operand::ofImmediate(OUTPUT_CAPACITY - OUTPUT_LINE_COPY));
+    emit(Mnemonic::JNS, 0, Operand::ofLabel(flushLabel));                  // No room for another line
+    emit(Mnemonic::RET, 0);
+
+    generateFlush();
+}
+
+/**
+ * Generates the flush_output routine, which writes the output buffer to stdout, retrying partial writes, and
+ * empties it. The executable cannot report a failed write any other way, so it exits with code 1.
+ */
+void Compiler::generateFlush() {
+    const std::uint32_t write = createLabel(".write");
+    const std::uint32_t advance = createLabel(".advance");
+    const std::uint32_t flushed = createLabel(".flushed");
+
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(flushLabel));
+    emit(Mnemonic::MOV, 64, RDX, Operand::ofSymbol(OUTPUT_USED_SYMBOL));
+    emit(Mnemonic::LEA, 64, RSI, Operand::ofSymbol(OUTPUT_SYMBOL));
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(write));
+    emit(Mnemonic::TEST, 64, RDX, RDX);
+    emit(Mnemonic::JZ, 0, Operand::ofLabel(flushed));
+    emit(Mnemonic::MOV, 32, RAX, Operand::ofImmediate(1));                  // System call for write
+    emit(Mnemonic::MOV, 32, RDI, Operand::ofImmediate(1));                  // stdout
+    emit(Mnemonic::SYSCALL, 0);
+    emit(Mnemonic::TEST, 64, RAX, RAX);
+    emit(Mnemonic::JNS, 0, Operand::ofLabel(advance));
+    emit(Mnemonic::MOV, 32, RAX, Operand::ofImmediate(60));                 // System call for exit
+    emit(Mnemonic::MOV, 32, RDI, Operand::ofImmediate(1));                  // Exit code 1
+    emit(Mnemonic::SYSCALL, 0);
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(advance));
+    emit(Mnemonic::ADD, 64, RSI, RAX);
+    emit(Mnemonic::SUB, 64, RDX, RAX);
+    emit(Mnemonic::JMP, 0, Operand::ofLabel(write));
+    emit(Mnemonic::LABEL, 0, Operand::ofLabel(flushed));
+    emit(Mnemonic::MOV, 64, Operand::ofSymbol(OUTPUT_USED_SYMBOL), Operand::ofImmediate(0));
+    emit(Mnemonic::RET, 0);
+}
+
+/**
+ * Generates code for assignment operations.
+ * Evaluates the expression into rax and moves it to the register allocated to the new value, or stores it to
+ * the variable if the value was spilled. Values that are never read generate no code.
+ *
+ * @param node - index of the ASSIGN node
+ */
+void Compiler::generateAssignment(const std::uint32_t node) {
+    if (locations[node] == RegisterAllocator::UNUSED) {
+        return;
+    }
+    generateExpression(program.left[node]);
+    emit(Mnemonic::MOV, 64, variableOperand(node), RAX);  // Store result
+}
+
+/**
+ * Generates code for an expression, leaving its value in rax.
+ * Values wrap on overflow, so addition and subtraction are associative and commutative: the expression is
+ * flattened into a signed sum of leaves, and long sums are split round-robin over several accumulators. Each
+ * accumulator is an independent dependency chain the processor can advance in parallel; they are added together
+ * pairwise at the end. Literals that do not fit a sign-extended 32-bit immediate are combined through rcx.
+ *
+ * @param node - index of the expression's root node
+ */
+void Compiler::generateExpression(const std::uint32_t node) {
+    collectTerms(node);
+
+    const std::size_t accumulatorCount = std::clamp<std::size_t>(terms.size() / TERMS_PER_ACCUMULATOR, 1,
+                                                                 std::size(ACCUMULATORS));
 
-        for (size_t i = 1; i < binOpNode->children.size(); ++i) {
-            const auto& rightOperand = binOpNode->children[i]->value;
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        const auto [leaf, negative] = terms[i];
+        const Operand accumulator = Operand::ofRegister(ACCUMULATORS[i % accumulatorCount]);
+        Operand operand = leafOperand(leaf);
 
-            if (binOpNode->op == '+') {
-                outFile << "    add eax, dword [" << rightOperand << "]\n";
-            } else if (binOpNode->op == '-') {
-                outFile << "    sub eax, dword [" << rightOperand << "]\n";
+        if (i < accumulatorCount) {
+            // The first term of an accumulator initializes it; a negated literal is negated at compile time
+            if (negative && operand.kind == Operand::IMMEDIATE) {
+                emit(Mnemonic::MOV, 64, accumulator, Operand::ofImmediate(wrappingSub(0, operand.immediate)));
+            } else {
+                emit(Mnemonic::MOV, 64, accumulator, operand);
+                if (negative) {
+                    emit(Mnemonic::NEG, 64, accumulator);
+                }
             }
+            continue;
         }
-        outFile << "    mov dword [" << node->value << "], eax\n";  // Store result
-    } else {
-        // Handle assignment of literals or identifiers
-        const std::string& childValue = node->children[0]->value;
+        if (operand.kind == Operand::IMMEDIATE && !fitsImmediate32(operand.immediate)) {
+            emit(Mnemonic::MOV, 64, RCX, operand);
+            operand = RCX;
+        }
+        emit(negative ? Mnemonic::SUB : Mnemonic::ADD, 64, accumulator, operand);
+    }
+
+    // Combine the accumulators as a balanced tree
+    for (std::size_t stride = 1; stride < accumulatorCount; stride *= 2) {
+        for (std::size_t i = 0; i + stride < accumulatorCount; i += 2 * stride) {
+            emit(Mnemonic::ADD, 64, Operand::ofRegister(ACCUMULATORS[i]),
+                 Operand::ofRegister(ACCUMULATORS[i + stride]));
+        }
+    }
+}
 
-        if (std::isdigit(childValue[0])) {
-            outFile << "    mov eax, " << childValue << "\n";
+/**
+ * Flattens an expression into its leaves, each with the sign it is summed with. Uses an explicit stack rather
+ * than recursion, so expressions with millions of terms cannot overflow the native stack; the leaves come out
+ * left to right.
+ *
+ * @param node - index of the expression's root node
+ */
+void Compiler::collectTerms(const std::uint32_t node) {
+    terms.clear();
+    pending.assign(1, {node, false});
+
+    while (!pending.empty()) {
+        const auto [current, negative] = pending.back();
+        pending.pop_back();
+
+        if (program.kinds[current] == BINARY_OP) {
+            pending.emplace_back(program.right[current], negative != (program.ops[current] == '-'));
+            pending.emplace_back(program.left[current], negative);
         } else {
-            outFile << "    mov eax, dword [" << childValue << "]\n";
+            terms.emplace_back(current, negative);
         }
-        outFile << "    mov dword [" << node->value << "], eax\n";
     }
 }
 
 /**
- * Generates assembly code for print operations in the AST, using printf.
+ * Generates code for print operations in the program: executables call the print_value routine, functions
+ * call the host's print function with its context and the value as arguments. Variables never live in the
+ * argument registers, so they can be loaded in any order.
  *
- * @param outFile - output file stream for assembly code
- * @param node - AST node representing a print operation
+ * @param node - index of the PRINT node
  */
-void Compiler::generatePrint(std::ofstream& outFile, const std::unique_ptr<ASTNode>& node) const {
-    if (node->value.empty()) {
-        std::cerr << "Error: Empty value in print statement.\n";
+void Compiler::generatePrint(const std::uint32_t node) {
+    if (target == Target::FUNCTION) {
+        emit(Mnemonic::MOV, 64, RDI, Operand::ofImmediate(static_cast<std::int64_t>(printContext)));
+        emit(Mnemonic::MOV, 64, RSI, variableOperand(node));
+        emit(Mnemonic::MOV, 64, RAX, Operand::ofImmediate(static_cast<std::int64_t>(printFunction)));
+        emit(Mnemonic::CALL, 64, RAX);
         return;
     }
-    outFile << "    mov eax, dword [" << node->value << "]\n";
-    outFile << "    push eax\n";
-    outFile << "    push output_format\n";
-    outFile << "    call printf\n";
-    outFile << "    add esp, 8\n";  // Clean up the stack after printf
+    emit(Mnemonic::MOV, 64, RAX, variableOperand(node));
+    emit(Mnemonic::CALL, 0, Operand::ofLabel(printLabel));
+}
+
+/**
+ * Generates code for program exit: writes the remaining buffered output, then terminates with exit code 0.
+ */
+void Compiler::generateExit() {
+    emit(Mnemonic::CALL, 0, Operand::ofLabel(flushLabel));
+    emit(Mnemonic::MOV, 32, RAX, Operand::ofImmediate(60));  // System call for exit
+    emit(Mnemonic::XOR, 32, RDI, RDI);                       // Exit code 0
+    emit(Mnemonic::SYSCALL, 0);
 }
 
 /**
- * Generates assembly code for program exit, terminating execution with exit code 0.
+ * Returns the operand for a leaf node.
  *
- * @param outFile - output file stream for assembly code
+ * @param node - index of a NUMBER or IDENTIFIER node
+ * @return an immediate for literals, or the variable's register or memory
  */
-void Compiler::generateExit(std::ofstream& outFile) const {
-    outFile << "    mov eax, 1\n";   // System call for exit
-    outFile << "    xor ebx, ebx\n"; // Exit code 0
-    outFile << "    int 0x80\n";     // Interrupt to terminate the program
+Operand Compiler::leafOperand(const std::uint32_t node) const {
+    if (program.kinds[node] == NUMBER) {
+        return Operand::ofImmediate(program.constants[program.operands[node]]);
+    }
+    return variableOperand(node);
 }
 
 /**
- * Compiles the generated assembly code with NASM and GCC, then runs the executable.
- * Handles errors during assembly, linking, or execution.
+ * Returns the operand holding the variable value read or written by a node.
+ *
+ * @param node - index of an IDENTIFIER, ASSIGN or PRINT node
+ * @return the allocated register, or the variable's memory for spilled values: its data symbol in executables,
+ *         its element of the slot array in functions
  */
-void Compiler::compileAndRun() const {
-    if (system("nasm -f win32 output.asm -o ls.o") != 0) {
-        std::cerr << "Error: NASM compilation failed.\n";
-        return;
+Operand Compiler::variableOperand(const std::uint32_t node) const {
+    const std::uint32_t slot = program.operands[node];
+
+    if (target == Target::FUNCTION) {
+        if (locations[node] >= 0) {
+            return Operand::ofRegister(FUNCTION_REGISTERS[locations[node]]);
+        }
+        return Operand::ofMemory(SLOT_BASE, static_cast<std::int32_t>(slot * sizeof(Value)));
     }
-    if (system("gcc ls.o -o LiteScript.exe") != 0) {
-        std::cerr << "Error: Linking failed.\n";
-        return;
+    if (locations[node] >= 0) {
+        return Operand::ofRegister(EXECUTABLE_REGISTERS[locations[node]]);
     }
-    if (system("LiteScript.exe") != 0) {
+    return Operand::ofSymbol(FIRST_SLOT_SYMBOL + slot);
+}
+
+/**
+ * Checks whether a literal can be encoded as the sign-extended 32-bit immediate of an arithmetic instruction.
+ *
+ * @param value - the literal value
+ * @return true if the value fits
+ */
+bool Compiler::fitsImmediate32(const Value value) {
+    return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+/**
+ * Appends an instruction to the machine program.
+ *
+ * @param mnemonic - the instruction
+ * @param width - operand width in bits
+ * @param destination - the destination operand
+ * @param source - the source operand
+ */
+void Compiler::emit(const Mnemonic mnemonic, const std::uint8_t width, const Operand& destination,
+                    const Operand& source) {
+    machine.code.push_back({mnemonic, width, destination, source});
+}
+
+/**
+ * Creates a code label.
+ *
+ * @param name - the label's name in the assembly listing
+ * @return the label index
+ */
+std::uint32_t Compiler::createLabel(const std::string& name) {
+    machine.labels.push_back(name);
+    return static_cast<std::uint32_t>(machine.labels.size() - 1);
+}
+
+/**
+ * Runs the compiled executable, reporting an error if it fails.
+ *
+ * @param filename - path of the executable
+ */
+void Compiler::run(const std::string& filename) {
+    const std::string command = filename.find('/') == std::string::npos ? "./" + filename : filename;
+
+    if (system(command.c_str()) != 0) {
         std::cerr << "Error: Execution failed.\n";
     }
 }
@@ -1,86 +1,217 @@
 #ifndef COMPILER_H
 #define COMPILER_H
 
-#include "AST.h"
-#include <vector>
+#include "FlatProgram.h"
+#include "MachineCode.h"
 #include <string>
-#include <memory>
-#include <fstream>
+#include <utility>
+#include <vector>
 
 /**
- * The Compiler class generates assembly code from an AST (Abstract Syntax Tree) and saves it to a file.
- * It provides methods to generate different sections of assembly code and handles the compilation
- * and execution of the generated code.
+ * The Compiler class generates native x86-64 code from a FlatProgram.
+ * It lowers the program to a MachineProgram, which is encoded straight into a static Linux executable and can
+ * also be printed as NASM assembly for inspection. Variables are kept in registers chosen by the
+ * RegisterAllocator and only fall back to memory when registers run out.
+ *
+ * The same statements can also be generated as a function for the JIT, called in-process with a pointer to the
+ * host's variable slots and printing through a host function instead of system calls.
  */
 class Compiler {
 public:
     /**
-     * Initializes the compiler with a reference to a vector of AST nodes.
+     * Initializes the compiler with a reference to a flat program.
      *
-     * @param nodes - AST nodes representing the program structure to be compiled
+     * @param program - the program to be compiled
      */
-    explicit Compiler(const std::vector<std::unique_ptr<ASTNode>>& nodes);
+    explicit Compiler(const FlatProgram& program);
 
     /**
-     * Generates the complete assembly code from the AST and saves it to the specified file.
+     * Generates the machine code of the program: the print_value routine, the statements, and the exit.
      *
-     * @param filename - the name of the file where the assembly code will be written
+     * @return the generated machine program
      */
-    void compile(const std::string& filename) const;
+    [[nodiscard]] MachineProgram generate();
+
+    /**
+     * Generates the program as a System V function `void (Value* slots)`. Spilled variables live in the slot
+     * array, every variable's final value is stored back to it before returning, and each print calls
+     * `void printFunction(void* printContext, Value)`.
+     *
+     * @param printFunction - address of the host function that prints a value
+     * @param printContext - pointer passed back to the print function with every value
+     * @return the generated machine program, whose entry label is the function
+     */
+    [[nodiscard]] MachineProgram generateFunction(std::uint64_t printFunction, std::uint64_t printContext);
+
+    /**
+     * Compiles the program into an executable, optionally writes its assembly alongside, and runs it.
+     *
+     * @param filename - path of the executable to create
+     * @param emitAsm - whether to also write the NASM source to filename + ".asm"
+     */
+    void compile(const std::string& filename, bool emitAsm = false);
+
+    /**
+     * Compiles the program into an executable and optionally writes its assembly alongside, without running it.
+     *
+     * @param filename - path of the executable to create
+     * @param emitAsm - whether to also write the NASM source to filename + ".asm"
+     */
+    void build(const std::string& filename, bool emitAsm = false);
 
-private:
     /**
-     * Generates the .data section of the assembly file, including static data like output format.
+     * Runs a compiled executable. Reports an error if it cannot be run or fails.
      *
-     * @param outFile - output file stream for writing the .data section
+     * @param filename - path of the executable
      */
-    void generateDataSection(std::ofstream& outFile) const;
+    static void run(const std::string& filename);
 
+private:
     /**
-     * Generates the .bss section of the assembly file to reserve memory space for program variables.
+     * Enum class selecting what kind of code is generated.
+     */
+    enum class Target {
+        EXECUTABLE,  // A standalone program with its own data, output routine and exit
+        FUNCTION     // A function working on the caller's slot array
+    };
+
+    /**
+     * Allocates registers and generates the code of every statement.
      *
-     * @param outFile - output file stream for writing the .bss section
+     * @param liveAtExit - whether every variable's final value must be available after the last statement
+     * @return the location of each slot's final value
+     */
+    std::vector<std::int8_t> generateStatements(bool liveAtExit);
+
+    /**
+     * Generates the function prologue: saves the callee-saved registers, aligns the stack for calls to the
+     * print function, and keeps the slot array pointer in the slot base register.
      */
-    void generateBssSection(std::ofstream& outFile) const;
+    void generatePrologue();
 
     /**
-     * Generates the .text section of the assembly file, containing the main program instructions.
+     * Generates the function epilogue: stores the final value of each variable held in a register back to its
+     * slot, restores the callee-saved registers and returns.
      *
-     * @param outFile - output file stream for writing the .text section
+     * @param exitLocations - location of each slot's final value
+     */
+    void generateEpilogue(const std::vector<std::int8_t>& exitLocations);
+
+    /**
+     * Declares the data used by the code: the output prefix, the output buffer and its fill level, and one
+     * quadword per variable slot.
+     */
+    void generateData();
+
+    /**
+     * Generates the print_value routine that appends "Result: N\n" for rax to the output buffer, and the
+     * flush_output routine that writes the buffer to stdout.
      */
-    void generateTextSection(std::ofstream& outFile) const;
+    void generateRuntime();
 
     /**
-     * Generates assembly code for assignment operations.
+     * Generates the flush_output routine, which writes the buffered output to stdout and empties the buffer.
+     */
+    void generateFlush();
+
+    /**
+     * Generates code for assignment operations.
      * Supports binary operations (e.g., addition, subtraction) and direct assignments.
      *
-     * @param outFile - output file stream for assignment instructions
-     * @param node - AST node representing an assignment operation
+     * @param node - index of the ASSIGN node
+     */
+    void generateAssignment(std::uint32_t node);
+
+    /**
+     * Generates code that leaves the value of an expression in rax.
+     *
+     * @param node - index of the expression's root node
+     */
+    void generateExpression(std::uint32_t node);
+
+    /**
+     * Flattens an expression into the signed leaves it sums, left to right, in terms.
+     *
+     * @param node - index of the expression's root node
+     */
+    void collectTerms(std::uint32_t node);
+
+    /**
+     * Generates code for print operations, displaying variable values through print_value.
+     *
+     * @param node - index of the PRINT node
+     */
+    void generatePrint(std::uint32_t node);
+
+    /**
+     * Generates code for program exit: flushes the output, then terminates with a system call.
+     */
+    void generateExit();
+
+    /**
+     * Returns the operand for a NUMBER or IDENTIFIER node: an immediate, a register or a memory reference.
+     *
+     * @param node - index of the leaf node
+     * @return the operand
      */
-    void generateAssignment(std::ofstream& outFile, const std::unique_ptr<ASTNode>& node) const;
+    [[nodiscard]] Operand leafOperand(std::uint32_t node) const;
 
     /**
-     * Generates assembly code for print operations, displaying variable values using printf.
+     * Returns the operand holding the variable value that a node reads or writes.
      *
-     * @param outFile - output file stream for print instructions
-     * @param node - AST node representing a print operation
+     * @param node - index of an IDENTIFIER, ASSIGN or PRINT node
+     * @return the allocated register or the variable's memory
      */
-    void generatePrint(std::ofstream& outFile, const std::unique_ptr<ASTNode>& node) const;
+    [[nodiscard]] Operand variableOperand(std::uint32_t node) const;
 
     /**
-     * Generates assembly code for program exit, using a system call to terminate execution.
+     * Checks whether a literal fits the sign-extended 32-bit immediate of an arithmetic instruction.
      *
-     * @param outFile - output file stream for exit instructions
+     * @param value - the literal value
+     * @return true if the value fits
      */
-    void generateExit(std::ofstream& outFile) const;
+    [[nodiscard]] static bool fitsImmediate32(Value value);
 
     /**
-     * Compiles and runs the generated assembly code using NASM and GCC.
-     * Handles errors in assembly, linking, or execution.
+     * Appends an instruction to the machine program.
+     *
+     * @param mnemonic - the instruction
+     * @param width - operand width in bits
+     * @param destination - the destination operand, if any
+     * @param source - the source operand, if any
      */
-    void compileAndRun() const;
+    void emit(Mnemonic mnemonic, std::uint8_t width, const Operand& destination = {}, const Operand& source = {});
+
+    /**
+     * Creates a code label.
+     *
+     * @param name - the label's name in the assembly listing
+     * @return the label index
+     */
+    std::uint32_t createLabel(const std::string& name);
+
+    static constexpr std::uint8_t EXECUTABLE_REGISTER_COUNT = 8;      // Registers available to variables in executables
+    static const Register EXECUTABLE_REGISTERS[];                     // Those registers, by allocator index
+    static constexpr std::uint8_t FUNCTION_REGISTER_COUNT = 5;        // Registers available to variables in functions
+    static const Register FUNCTION_REGISTERS[];                       // Those registers, by allocator index
+    static constexpr Register SLOT_BASE = Register::R15;              // Holds the slot array pointer in functions
+    static constexpr std::uint32_t PREFIX_SYMBOL = 0;                 // Symbol of the "Result: " prefix
+    static constexpr std::uint32_t OUTPUT_SYMBOL = 1;                 // Symbol of the output buffer
+    static constexpr std::uint32_t OUTPUT_USED_SYMBOL = 2;            // Symbol of the number of bytes buffered
+    static constexpr std::uint32_t FIRST_SLOT_SYMBOL = 3;             // Symbol of slot 0; slot i is this plus i
+    static constexpr std::int32_t OUTPUT_CAPACITY = 1 << 16;          // Bytes of output buffered before a write
+    static constexpr std::int32_t OUTPUT_LINE_COPY = 32;              // Bytes copied per line, more than the longest
 
-    const std::vector<std::unique_ptr<ASTNode>>& ast;  // Reference to the AST nodes to be compiled
+    const FlatProgram& program;         // Reference to the program to be compiled
+    std::vector<std::int8_t> locations; // Register or memory location of each variable access, per node
+    MachineProgram machine;             // Machine program being generated
+    std::uint32_t printLabel = 0;       // Label of the print_value routine
+    std::uint32_t flushLabel = 0;       // Label of the flush_output routine
+    Target target = Target::EXECUTABLE; // Kind of code being generated
+    std::uint64_t printFunction = 0;    // Address of the host print function, for functions
+    std::uint64_t printContext = 0;     // First argument of the host print function, for functions
+    std::vector<std::pair<std::uint32_t, bool>> terms;    // Leaves of the current expression, and whether each is negated
+    std::vector<std::pair<std::uint32_t, bool>> pending;  // Explicit stack for flattening expressions
 };
 
 #endif // COMPILER_H
@@ -0,0 +1,56 @@
+#include "ContentHash.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    /**
+     * Finalizes a hash lane like SplitMix64, so every input bit affects every output bit.
+     */
+    std::uint64_t mix(std::uint64_t hash) {
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        return hash ^ (hash >> 31);
+    }
+}
+
+/**
+ * Mixes each eight-byte word into both lanes, the second seeing it with its halves swapped, then the length.
+ *
+ * @param bytes - the field's bytes
+ */
+void ContentHash::add(const std::string_view bytes) {
+    for (std::size_t i = 0; i < bytes.size(); i += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + i, std::min<std::size_t>(8, bytes.size() - i));
+        lanes[0] = mix(lanes[0] ^ word);
+        lanes[1] = mix(lanes[1] + (word << 32 | word >> 32));
+    }
+    lanes[0] = mix(lanes[0] ^ bytes.size());
+    lanes[1] = mix(lanes[1] + bytes.size());
+}
+
+/**
+ * Returns the first lane.
+ *
+ * @return the hash as a number
+ */
+std::uint64_t ContentHash::value() const {
+    return lanes[0];
+}
+
+/**
+ * Formats both lanes as hexadecimal.
+ *
+ * @return the hash in 32 hexadecimal digits
+ */
+std::string ContentHash::hex() const {
+    static constexpr char HEX[] = "0123456789abcdef";
+    std::string text;
+
+    for (const std::uint64_t lane : lanes) {
+        for (int shift = 60; shift >= 0; shift -= 4) {
+            text += HEX[lane >> shift & 0xF];
+        }
+    }
+    return text;
+}
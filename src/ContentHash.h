@@ -0,0 +1,41 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * ContentHash class hashes byte strings into 128 bits, eight bytes at a time over two independently seeded
+ * lanes. It identifies content in the build cache and checksums bytecode files; it is fast and well mixed, but
+ * not cryptographic.
+ */
+class ContentHash {
+public:
+    /**
+     * Adds a field to the hash. Its length is hashed after its bytes, so consecutive fields cannot run into
+     * each other.
+     *
+     * @param bytes - the field's bytes
+     */
+    void add(std::string_view bytes);
+
+    /**
+     * Returns the first 64 bits of the hash.
+     *
+     * @return the hash as a number
+     */
+    [[nodiscard]] std::uint64_t value() const;
+
+    /**
+     * Returns all 128 bits of the hash.
+     *
+     * @return the hash in 32 hexadecimal digits
+     */
+    [[nodiscard]] std::string hex() const;
+
+private:
+    std::uint64_t lanes[2] = {0x9E3779B97F4A7C15ull, 0xD1B54A32D192ED03ull};  // Hash state, one per lane
+};
+
+#endif // CONTENT_HASH_H
@@ -0,0 +1,138 @@
+#include "ElfWriter.h"
+#include "X86Encoder.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+    /**
+     * Appends a little-endian value of the given size.
+     */
+    void put(std::vector<std::uint8_t>& image, const std::uint64_t value, const int size) {
+        for (int i = 0; i < size; ++i) {
+            image.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    /**
+     * Rounds a value up to a multiple of a power-of-two alignment.
+     */
+    std::uint64_t alignUp(const std::uint64_t value, const std::uint64_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+// Constructor initializes the writer with a machine program
+ElfWriter::ElfWriter(const MachineProgram& program) : program(program) {}
+
+/**
+ * Lays out the code, initialized data and zeroed data, links the encoded code against that layout, and writes
+ * the headers and contents to an executable file.
+ *
+ * @param filename - path of the executable to create
+ */
+void ElfWriter::write(const std::string& filename) const {
+    X86Encoder encoder(program);
+    encoder.encode();
+
+    const std::uint64_t codeOffset = HEADER_SIZE + SEGMENT_COUNT * SEGMENT_HEADER_SIZE;
+    std::uint64_t textSize = codeOffset + encoder.code().size();
+    std::uint64_t bssSize = 0;
+    std::vector<std::uint64_t> symbolOffsets(program.symbols.size());
+
+    // Initialized data follows the code in the text segment; zeroed data gets its own segment
+    for (std::size_t i = 0; i < program.symbols.size(); ++i) {
+        std::uint64_t& end = program.symbols[i].initializer.empty() ? bssSize : textSize;
+
+        end = alignUp(end, 8);
+        symbolOffsets[i] = end;
+        end += program.symbols[i].size;
+    }
+
+    const std::uint64_t bssAddress = alignUp(BASE_ADDRESS + textSize, PAGE_SIZE);
+    std::vector<std::uint64_t> symbolAddresses(program.symbols.size());
+
+    for (std::size_t i = 0; i < program.symbols.size(); ++i) {
+        const std::uint64_t base = program.symbols[i].initializer.empty() ? bssAddress : BASE_ADDRESS;
+        symbolAddresses[i] = base + symbolOffsets[i];
+    }
+    encoder.link(BASE_ADDRESS + codeOffset, symbolAddresses);
+
+    std::vector<std::uint8_t> image;
+    image.reserve(textSize);
+    appendFileHeader(image, BASE_ADDRESS + codeOffset + encoder.labelOffset(program.entry));
+    appendSegmentHeader(image, 4 | 1, 0, BASE_ADDRESS, textSize, textSize);
+    appendSegmentHeader(image, 4 | 2, 0, bssAddress, 0, std::max<std::uint64_t>(bssSize, 8));
+    image.insert(image.end(), encoder.code().begin(), encoder.code().end());
+
+    for (std::size_t i = 0; i < program.symbols.size(); ++i) {
+        const DataSymbol& symbol = program.symbols[i];
+
+        if (!symbol.initializer.empty()) {
+            image.resize(symbolOffsets[i], 0);
+            image.insert(image.end(), symbol.initializer.begin(), symbol.initializer.end());
+        }
+    }
+
+    std::ofstream outFile(filename, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        throw std::runtime_error("Could not open file for writing: " + filename);
+    }
+    outFile.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    outFile.close();
+    if (!outFile || chmod(filename.c_str(), 0755) != 0) {
+        throw std::runtime_error("Could not write executable: " + filename);
+    }
+}
+
+/**
+ * Appends the 64-byte ELF header of a little-endian x86-64 executable.
+ *
+ * @param image - the file contents
+ * @param entry - address of the first instruction to execute
+ */
+void ElfWriter::appendFileHeader(std::vector<std::uint8_t>& image, const std::uint64_t entry) {
+    put(image, 0x464C457F, 4);          // Magic: 0x7F 'E' 'L' 'F'
+    put(image, 2, 1);                   // 64-bit
+    put(image, 1, 1);                   // Little endian
+    put(image, 1, 1);                   // ELF version
+    put(image, 0, 1);                   // System V ABI
+    put(image, 0, 8);                   // Padding
+    put(image, 2, 2);                   // Executable file
+    put(image, 0x3E, 2);                // x86-64
+    put(image, 1, 4);                   // ELF version
+    put(image, entry, 8);               // Entry point
+    put(image, HEADER_SIZE, 8);         // Program headers follow the ELF header
+    put(image, 0, 8);                   // No section headers
+    put(image, 0, 4);                   // Flags
+    put(image, HEADER_SIZE, 2);
+    put(image, SEGMENT_HEADER_SIZE, 2);
+    put(image, SEGMENT_COUNT, 2);
+    put(image, 64, 2);                  // Section header size
+    put(image, 0, 2);                   // Section header count
+    put(image, 0, 2);                   // Section name table index
+}
+
+/**
+ * Appends a PT_LOAD program header.
+ *
+ * @param image - the file contents
+ * @param flags - segment permissions
+ * @param offset - offset of the segment in the file
+ * @param address - address the segment is loaded at
+ * @param fileSize - bytes of the segment stored in the file
+ * @param memorySize - bytes of the segment in memory
+ */
+void ElfWriter::appendSegmentHeader(std::vector<std::uint8_t>& image, const std::uint32_t flags,
+                                    const std::uint64_t offset, const std::uint64_t address,
+                                    const std::uint64_t fileSize, const std::uint64_t memorySize) {
+    put(image, 1, 4);                   // PT_LOAD
+    put(image, flags, 4);
+    put(image, offset, 8);
+    put(image, address, 8);             // Virtual address
+    put(image, address, 8);             // Physical address
+    put(image, fileSize, 8);
+    put(image, memorySize, 8);
+    put(image, PAGE_SIZE, 8);           // Alignment
+}
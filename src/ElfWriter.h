@@ -0,0 +1,63 @@
+#ifndef ELF_WRITER_H
+#define ELF_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MachineCode.h"
+
+/**
+ * The ElfWriter class encodes a MachineProgram and writes it as a static x86-64 Linux executable.
+ *
+ * The file has no sections, only two program headers: a read-and-execute segment holding the headers, the code
+ * and the initialized data, and a read-write segment for the zeroed data, which takes no space in the file.
+ */
+class ElfWriter {
+public:
+    /**
+     * Initializes the writer with a reference to a machine program.
+     *
+     * @param program - the program to write
+     */
+    explicit ElfWriter(const MachineProgram& program);
+
+    /**
+     * Encodes the program and writes it as an executable file.
+     * Throws if the file cannot be written.
+     *
+     * @param filename - path of the executable to create
+     */
+    void write(const std::string& filename) const;
+
+private:
+    static constexpr std::uint64_t BASE_ADDRESS = 0x400000;  // Address the file is mapped at
+    static constexpr std::uint64_t PAGE_SIZE = 0x1000;       // Segment alignment
+    static constexpr std::uint32_t HEADER_SIZE = 64;         // Size of the ELF header
+    static constexpr std::uint32_t SEGMENT_HEADER_SIZE = 56; // Size of a program header
+    static constexpr std::uint32_t SEGMENT_COUNT = 2;        // Text and zeroed data
+
+    /**
+     * Appends the ELF header.
+     *
+     * @param image - the file contents
+     * @param entry - address of the first instruction to execute
+     */
+    static void appendFileHeader(std::vector<std::uint8_t>& image, std::uint64_t entry);
+
+    /**
+     * Appends a loadable program header.
+     *
+     * @param image - the file contents
+     * @param flags - segment permissions (PF_X = 1, PF_W = 2, PF_R = 4)
+     * @param offset - offset of the segment in the file
+     * @param address - address the segment is loaded at
+     * @param fileSize - bytes of the segment stored in the file
+     * @param memorySize - bytes of the segment in memory; anything past fileSize is zeroed
+     */
+    static void appendSegmentHeader(std::vector<std::uint8_t>& image, std::uint32_t flags, std::uint64_t offset,
+                                    std::uint64_t address, std::uint64_t fileSize, std::uint64_t memorySize);
+
+    const MachineProgram& program;  // Reference to the program to be written
+};
+
+#endif // ELF_WRITER_H
@@ -0,0 +1,104 @@
+#ifndef FLAT_PROGRAM_H
+#define FLAT_PROGRAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AST.h"
+#include "Value.h"
+
+/**
+ * Struct representing a resolved program as flat, index-based arrays (struct-of-arrays).
+ *
+ * Node i is described by kinds[i], ops[i], operands[i], left[i] and right[i], about 14 bytes per node.
+ * Nodes are stored in post-order, statement by statement, so every child precedes its parent and the
+ * nodes of one statement are contiguous, ending with the statement's ASSIGN or PRINT root. Executing the
+ * program is therefore a single forward scan over the arrays.
+ */
+struct FlatProgram {
+    std::vector<NodeType> kinds;           // Kind of each node
+    std::vector<char> ops;                 // Operator of each BINARY_OP node ('+' or '-')
+    std::vector<std::uint32_t> operands;   // Slot for IDENTIFIER, ASSIGN and PRINT; constant index for NUMBER
+    std::vector<std::uint32_t> left;       // Left operand of BINARY_OP, expression root of ASSIGN
+    std::vector<std::uint32_t> right;      // Right operand of BINARY_OP
+    std::vector<std::uint32_t> statements; // Index of each statement's root node, in program order
+    std::vector<Value> constants;          // Parsed value of each numeric literal
+    std::vector<std::string> slotNames;    // Interned variable name of each slot
+    std::uint32_t maxStatementSize = 0;    // Node count of the largest statement
+
+    /**
+     * Returns the number of nodes in the program.
+     *
+     * @return the node count
+     */
+    [[nodiscard]] std::uint32_t size() const { return static_cast<std::uint32_t>(kinds.size()); }
+
+    /**
+     * Removes every node, statement and constant, keeping the slot table (and the arrays' capacity).
+     * Used when streaming, where each statement is executed and dropped before the next one is added.
+     */
+    void clearCode() {
+        kinds.clear();
+        ops.clear();
+        operands.clear();
+        left.clear();
+        right.clear();
+        statements.clear();
+        constants.clear();
+        maxStatementSize = 0;
+    }
+
+    /**
+     * Appends a node whose children, if any, have already been appended.
+     *
+     * @param kind - the node kind
+     * @param op - the operator of a BINARY_OP node
+     * @param operand - the slot or constant index
+     * @param leftChild - the left operand or assigned expression
+     * @param rightChild - the right operand
+     * @return the index of the new node
+     */
+    std::uint32_t appendNode(const NodeType kind, const char op, const std::uint32_t operand,
+                             const std::uint32_t leftChild = 0, const std::uint32_t rightChild = 0) {
+        kinds.push_back(kind);
+        ops.push_back(op);
+        operands.push_back(operand);
+        left.push_back(leftChild);
+        right.push_back(rightChild);
+        return size() - 1;
+    }
+
+    /**
+     * Adds a value to the constant pool.
+     *
+     * @param value - the constant
+     * @return its index, the operand of a NUMBER node
+     */
+    std::uint32_t addConstant(const Value value) {
+        constants.push_back(value);
+        return static_cast<std::uint32_t>(constants.size() - 1);
+    }
+
+    /**
+     * Records the last appended node as the root of a new statement.
+     */
+    void endStatement() {
+        const std::uint32_t start = statementStart(statements.size());
+
+        statements.push_back(size() - 1);
+        maxStatementSize = std::max(maxStatementSize, size() - start);
+    }
+
+    /**
+     * Returns the index of the first node of a statement.
+     *
+     * @param statement - the statement's position in program order
+     * @return the index of its first node
+     */
+    [[nodiscard]] std::uint32_t statementStart(const std::size_t statement) const {
+        return statement == 0 ? 0 : statements[statement - 1] + 1;
+    }
+};
+
+#endif // FLAT_PROGRAM_H
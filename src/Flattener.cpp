@@ -0,0 +1,102 @@
+#include "Flattener.h"
+#include <charconv>
+#include <stdexcept>
+
+// Constructor initializes the flattener with the program to append to
+Flattener::Flattener(FlatProgram& program) : program(program) {}
+
+/**
+ * Lowers every statement into the flat program, in program order.
+ *
+ * @param nodes - AST nodes annotated by the Resolver
+ */
+void Flattener::flatten(const std::vector<ASTNode*>& nodes) {
+    for (const ASTNode* node : nodes) {
+        if (node) {
+            flattenStatement(*node);  // Statements the parser rejected are null
+        }
+    }
+}
+
+/**
+ * Lowers a single statement and records it in the program's statement list.
+ *
+ * @param statement - the statement's ASSIGN or PRINT node
+ */
+void Flattener::flattenStatement(const ASTNode& statement) {
+    appendTree(statement);
+    program.endStatement();
+}
+
+/**
+ * Appends the nodes of one tree in post-order, walking it with an explicit stack.
+ *
+ * @param root - the root of the tree
+ * @return the index of the root node
+ */
+std::uint32_t Flattener::appendTree(const ASTNode& root) {
+    frames.push_back({&root, 0});
+
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+
+        if (frame.nextChild < frame.node->children.size()) {
+            const ASTNode* child = frame.node->children[frame.nextChild++];
+            frames.push_back({child, 0});
+            continue;
+        }
+        // All children are done: their indices are the last entries of 'completed'
+        const ASTNode* node = frame.node;
+        frames.pop_back();
+
+        const auto firstChild = completed.end() - static_cast<std::ptrdiff_t>(node->children.size());
+        children.assign(firstChild, completed.end());
+        completed.erase(firstChild, completed.end());
+        completed.push_back(appendNode(*node, children));
+    }
+    const std::uint32_t index = completed.back();
+    completed.clear();
+    return index;
+}
+
+/**
+ * Appends a single node to every array of the program.
+ * Numeric literals are parsed here and added to the constant pool.
+ *
+ * @param node - the AST node
+ * @param childIndices - the flat indices of the node's children
+ * @return the index of the new node
+ */
+std::uint32_t Flattener::appendNode(const ASTNode& node, const std::vector<std::uint32_t>& childIndices) {
+    std::uint32_t operand = 0;
+    std::uint32_t leftChild = 0;
+    std::uint32_t rightChild = 0;
+
+    switch (node.type) {
+        case NUMBER: {
+            Value value = 0;
+            const char* end = node.value.data() + node.value.size();
+
+            const auto [parsedEnd, error] = std::from_chars(node.value.data(), end, value);
+
+            if (error != std::errc() || parsedEnd != end) {
+                throw std::runtime_error("Number out of range: " + std::string(node.value));
+            }
+            operand = program.addConstant(value);
+            break;
+        }
+        case IDENTIFIER:
+        case PRINT:
+            operand = static_cast<std::uint32_t>(node.slot);
+            break;
+        case ASSIGN:
+            operand = static_cast<std::uint32_t>(node.slot);
+            leftChild = childIndices[0];
+            break;
+        case BINARY_OP:
+            leftChild = childIndices[0];
+            rightChild = childIndices[1];
+            break;
+    }
+    return program.appendNode(node.type, node.op, operand, leftChild, rightChild);
+}
@@ -0,0 +1,68 @@
+#ifndef FLATTENER_H
+#define FLATTENER_H
+
+#include <vector>
+#include "AST.h"
+#include "FlatProgram.h"
+
+/**
+ * The Flattener class lowers a resolved AST into a FlatProgram.
+ * Numeric literals are parsed into 64-bit constants here, once, and identifiers become their slot ids.
+ * Statements are appended to the target program, either a whole AST at a time or one by one.
+ */
+class Flattener {
+public:
+    /**
+     * Initializes the flattener with the program to append to.
+     *
+     * @param program - the flat program receiving the lowered statements
+     */
+    explicit Flattener(FlatProgram& program);
+
+    /**
+     * Lowers every statement of a resolved AST into the program.
+     * Throws if a numeric literal does not fit in a 64-bit value.
+     *
+     * @param nodes - AST nodes annotated by the Resolver
+     */
+    void flatten(const std::vector<ASTNode*>& nodes);
+
+    /**
+     * Lowers a single resolved statement into the program.
+     * Throws if a numeric literal does not fit in a 64-bit value.
+     *
+     * @param statement - the statement's ASSIGN or PRINT node
+     */
+    void flattenStatement(const ASTNode& statement);
+
+private:
+    // A node whose children are still being appended during the post-order walk
+    struct Frame {
+        const ASTNode* node;
+        std::size_t nextChild;
+    };
+
+    FlatProgram& program;                  // Program being appended to
+    std::vector<Frame> frames;             // Explicit walk stack, so deep operator chains cannot overflow
+    std::vector<std::uint32_t> completed;  // Flat indices of finished subtrees awaiting their parent
+    std::vector<std::uint32_t> children;   // Child indices of the node being appended
+
+    /**
+     * Appends the nodes of one tree in post-order.
+     *
+     * @param root - the root of the tree
+     * @return the index of the root node
+     */
+    std::uint32_t appendTree(const ASTNode& root);
+
+    /**
+     * Appends a single node, whose children must already have been appended.
+     *
+     * @param node - the AST node
+     * @param childIndices - the flat indices of the node's children
+     * @return the index of the new node
+     */
+    std::uint32_t appendNode(const ASTNode& node, const std::vector<std::uint32_t>& childIndices);
+};
+
+#endif // FLATTENER_H
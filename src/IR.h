@@ -0,0 +1,85 @@
+#ifndef IR_H
+#define IR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Value.h"
+
+/**
+ * Enum class representing the operations of the SSA intermediate representation.
+ */
+enum class IROpcode : std::uint8_t {
+    CONST,  // The constant immediates[i]
+    INPUT,  // The value variable slots[i] holds before the program runs
+    ADD,    // lhs[i] + rhs[i], wrapping on overflow
+    SUB,    // lhs[i] - rhs[i], wrapping on overflow
+    SHOW    // Print the value lhs[i]; defines no value
+};
+
+/**
+ * Enum class representing the type of an instruction's result.
+ */
+enum class IRType : std::uint8_t {
+    I64,   // A 64-bit integer
+    VOID   // No value
+};
+
+/**
+ * Struct representing a program in static single assignment form, as flat arrays (struct-of-arrays).
+ *
+ * Programs are straight-line, so instruction i simply defines value %i, and an operand is valid exactly when it
+ * names an earlier instruction that has a value. Variables do not exist as storage: every `let` defines a new
+ * value and records the variable it was bound to in slots[i], a use of a variable is a use of its current value,
+ * and exits[s] is the value variable s holds when the program ends.
+ */
+struct IRProgram {
+    static constexpr std::uint32_t NONE = UINT32_MAX;  // No operand, variable or value
+
+    std::vector<IROpcode> opcodes;           // Operation of each instruction
+    std::vector<std::uint32_t> lhs;          // First operand of ADD and SUB, value shown by SHOW
+    std::vector<std::uint32_t> rhs;          // Second operand of ADD and SUB
+    std::vector<Value> immediates;           // Constant of CONST
+    std::vector<std::uint32_t> slots;        // Variable a `let` bound the value to, read by INPUT, or named by SHOW
+    std::vector<std::string> slotNames;      // Name of each variable
+    std::vector<std::uint32_t> exits;        // Final value of each variable, or NONE if it is not kept
+
+    /**
+     * Returns the number of instructions.
+     *
+     * @return the instruction count
+     */
+    [[nodiscard]] std::uint32_t size() const { return static_cast<std::uint32_t>(opcodes.size()); }
+
+    /**
+     * Returns the type of an instruction's result.
+     *
+     * @param value - the instruction
+     * @return VOID for SHOW, I64 otherwise
+     */
+    [[nodiscard]] IRType typeOf(const std::uint32_t value) const {
+        return opcodes[value] == IROpcode::SHOW ? IRType::VOID : IRType::I64;
+    }
+
+    /**
+     * Appends an instruction.
+     *
+     * @param opcode - the operation
+     * @param first - first operand, or NONE
+     * @param second - second operand, or NONE
+     * @param immediate - the constant of a CONST
+     * @param slot - the variable bound, read or named, or NONE
+     * @return the new instruction's value
+     */
+    std::uint32_t append(const IROpcode opcode, const std::uint32_t first = NONE, const std::uint32_t second = NONE,
+                         const Value immediate = 0, const std::uint32_t slot = NONE) {
+        opcodes.push_back(opcode);
+        lhs.push_back(first);
+        rhs.push_back(second);
+        immediates.push_back(immediate);
+        slots.push_back(slot);
+        return size() - 1;
+    }
+};
+
+#endif // IR_H
@@ -0,0 +1,69 @@
+#include "IRBuilder.h"
+
+// Constructor initializes the builder with the IR program to fill
+IRBuilder::IRBuilder(IRProgram& ir) : ir(ir) {}
+
+/**
+ * Translates the program statement by statement. Nodes are in post-order, so the values of a node's children
+ * are known when the node is reached.
+ *
+ * @param program - the program to translate
+ */
+void IRBuilder::build(const FlatProgram& program) {
+    ir = IRProgram();
+    ir.slotNames = program.slotNames;
+    current.assign(program.slotNames.size(), IRProgram::NONE);
+
+    for (std::size_t statement = 0; statement < program.statements.size(); ++statement) {
+        const std::uint32_t start = program.statementStart(statement);
+        const std::uint32_t root = program.statements[statement];
+        const std::uint32_t firstInstruction = ir.size();
+
+        values.resize(root - start + 1);
+        for (std::uint32_t node = start; node <= root; ++node) {
+            std::uint32_t& value = values[node - start];
+
+            switch (program.kinds[node]) {
+                case NUMBER:
+                    value = ir.append(IROpcode::CONST, IRProgram::NONE, IRProgram::NONE,
+                                      program.constants[program.operands[node]]);
+                    break;
+                case IDENTIFIER:
+                    value = currentValue(program.operands[node]);
+                    break;
+                case BINARY_OP:
+                    value = ir.append(program.ops[node] == '+' ? IROpcode::ADD : IROpcode::SUB,
+                                      values[program.left[node] - start], values[program.right[node] - start]);
+                    break;
+                case ASSIGN: {
+                    const std::uint32_t assigned = values[program.left[node] - start];
+
+                    // Bind the variable to a value this statement computed; a plain copy just shares the value
+                    if (assigned >= firstInstruction && ir.slots[assigned] == IRProgram::NONE) {
+                        ir.slots[assigned] = program.operands[node];
+                    }
+                    current[program.operands[node]] = assigned;
+                    break;
+                }
+                case PRINT:
+                    ir.append(IROpcode::SHOW, currentValue(program.operands[node]), IRProgram::NONE, 0,
+                              program.operands[node]);
+                    break;
+            }
+        }
+    }
+    ir.exits = current;
+}
+
+/**
+ * Returns the current value of a variable.
+ *
+ * @param slot - the variable
+ * @return the value
+ */
+std::uint32_t IRBuilder::currentValue(const std::uint32_t slot) {
+    if (current[slot] == IRProgram::NONE) {
+        current[slot] = ir.append(IROpcode::INPUT, IRProgram::NONE, IRProgram::NONE, 0, slot);
+    }
+    return current[slot];
+}
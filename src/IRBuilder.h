@@ -0,0 +1,45 @@
+#ifndef IR_BUILDER_H
+#define IR_BUILDER_H
+
+#include <cstdint>
+#include <vector>
+#include "FlatProgram.h"
+#include "IR.h"
+
+/**
+ * The IRBuilder class translates a resolved FlatProgram into SSA form.
+ * It tracks the current value of every variable while scanning the statements: reads become uses of that value,
+ * and each `let` binds its variable to the value of its expression. An assignment that merely copies another
+ * variable creates no instruction at all.
+ */
+class IRBuilder {
+public:
+    /**
+     * Initializes the builder with the IR program to fill.
+     *
+     * @param ir - the program receiving the instructions
+     */
+    explicit IRBuilder(IRProgram& ir);
+
+    /**
+     * Translates every statement of a flat program, replacing the contents of the IR program.
+     *
+     * @param program - the program to translate
+     */
+    void build(const FlatProgram& program);
+
+private:
+    /**
+     * Returns the current value of a variable, reading it with an INPUT instruction if it has not been assigned.
+     *
+     * @param slot - the variable
+     * @return the value
+     */
+    std::uint32_t currentValue(std::uint32_t slot);
+
+    IRProgram& ir;                        // Program being built
+    std::vector<std::uint32_t> current;   // Current value of each variable
+    std::vector<std::uint32_t> values;    // Value of each node of the current statement, indexed from its first node
+};
+
+#endif // IR_BUILDER_H
@@ -0,0 +1,218 @@
+#include "IRLowerer.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr std::uint32_t EXPANDED = 0x80000000u;  // Marks a pending operation whose operands are already emitted
+}
+
+// Constructor initializes the lowerer with the IR to read and the flat program to fill
+IRLowerer::IRLowerer(const IRProgram& ir, FlatProgram& program) : ir(ir), program(program) {}
+
+/**
+ * Lowers the program: each stored value becomes an assignment at its position, each show a print of the
+ * variable holding its value, and the final values are put in place at the end.
+ */
+void IRLowerer::lower() {
+    // Pending operations are tagged with EXPANDED in their index's top bit, so no index may reach it
+    if (ir.size() >= EXPANDED) {
+        throw std::runtime_error("Program too large: " + std::to_string(ir.size()) + " IR instructions");
+    }
+    program = FlatProgram();
+    program.slotNames = ir.slotNames;
+
+    chooseStoredValues();
+    assignHomes();
+
+    for (std::uint32_t value = 0; value < ir.size(); ++value) {
+        const IROpcode opcode = ir.opcodes[value];
+
+        if (opcode == IROpcode::SHOW) {
+            program.appendNode(PRINT, '\0', homes[ir.lhs[value]]);
+            program.endStatement();
+        } else if (opcode == IROpcode::INPUT) {
+            // An input overwritten while still needed is copied to its temporary before the overwrite
+            if (homes[value] != ir.slots[value]) {
+                const std::uint32_t read = program.appendNode(IDENTIFIER, '\0', ir.slots[value]);
+                program.appendNode(ASSIGN, '\0', homes[value], read);
+                program.endStatement();
+            }
+        } else if (stored[value]) {
+            const std::uint32_t expression = emitExpression(value);
+            program.appendNode(ASSIGN, '\0', homes[value], expression);
+            program.endStatement();
+        }
+    }
+    emitExits();
+}
+
+/**
+ * Decides which values are stored. A value that is folded into its user is read when that user's statement
+ * runs, so read positions are propagated backwards from users to the operands they absorb.
+ */
+void IRLowerer::chooseStoredValues() {
+    const std::uint32_t size = ir.size();
+    std::vector<std::uint32_t> uses(size, 0);
+    std::vector<std::uint32_t> users(size, IRProgram::NONE);
+    std::vector<bool> kept(size, false);  // Shown or final
+
+    for (std::uint32_t value = 0; value < size; ++value) {
+        if (ir.opcodes[value] == IROpcode::ADD || ir.opcodes[value] == IROpcode::SUB) {
+            ++uses[ir.lhs[value]];
+            ++uses[ir.rhs[value]];
+            users[ir.lhs[value]] = value;
+            users[ir.rhs[value]] = value;
+        } else if (ir.opcodes[value] == IROpcode::SHOW) {
+            kept[ir.lhs[value]] = true;
+        }
+    }
+    for (const std::uint32_t value : ir.exits) {
+        if (value != IRProgram::NONE) {
+            kept[value] = true;
+        }
+    }
+
+    stored.assign(size, false);
+    for (std::uint32_t value = 0; value < size; ++value) {
+        switch (ir.opcodes[value]) {
+            case IROpcode::INPUT:
+                stored[value] = true;
+                break;
+            case IROpcode::CONST:
+                stored[value] = kept[value] || ir.slots[value] != IRProgram::NONE;
+                break;
+            case IROpcode::ADD:
+            case IROpcode::SUB:
+                stored[value] = kept[value] || ir.slots[value] != IRProgram::NONE || uses[value] > 1;
+                break;
+            case IROpcode::SHOW:
+                break;
+        }
+    }
+
+    // Position of the statement each instruction is emitted in: its own, or that of the user it is folded into
+    std::vector<std::uint32_t> position(size);
+    for (std::uint32_t value = size; value-- > 0;) {
+        const bool folded = !stored[value] && ir.opcodes[value] != IROpcode::SHOW && users[value] != IRProgram::NONE;
+        position[value] = folded ? position[users[value]] : value;
+    }
+
+    readAt.assign(size, 0);
+    for (std::uint32_t value = 0; value < size; ++value) {
+        const IROpcode opcode = ir.opcodes[value];
+
+        if (opcode == IROpcode::SHOW) {
+            readAt[ir.lhs[value]] = std::max(readAt[ir.lhs[value]], position[value]);
+        } else if (opcode == IROpcode::ADD || opcode == IROpcode::SUB) {
+            // Constants are written as literals, so only other stored operands are read from a variable
+            for (const std::uint32_t operand : {ir.lhs[value], ir.rhs[value]}) {
+                if (stored[operand] && ir.opcodes[operand] != IROpcode::CONST) {
+                    readAt[operand] = std::max(readAt[operand], position[value]);
+                }
+            }
+        }
+    }
+    for (const std::uint32_t value : ir.exits) {
+        if (value != IRProgram::NONE) {
+            readAt[value] = size;  // Read once the program ends
+        }
+    }
+}
+
+/**
+ * Chooses each stored value's variable. A value stays in the variable it was bound to (or, for an input, the
+ * variable it reads) unless that variable is written again before the value's last read, or the value is
+ * another variable's final value while its own variable ends up holding something else. Otherwise it gets a
+ * temporary.
+ */
+void IRLowerer::assignHomes() {
+    const std::uint32_t size = ir.size();
+    std::vector<std::uint32_t> nextWrite(ir.slotNames.size(), size);
+    std::vector<bool> final(size, false);
+
+    for (const std::uint32_t value : ir.exits) {
+        if (value != IRProgram::NONE) {
+            final[value] = true;
+        }
+    }
+
+    homes.assign(size, IRProgram::NONE);
+    for (std::uint32_t value = size; value-- > 0;) {
+        if (!stored[value]) {
+            continue;
+        }
+        const std::uint32_t slot = ir.slots[value];
+        const bool writes = ir.opcodes[value] != IROpcode::INPUT;
+
+        // A statement reads its operands before writing, so a read in the writing statement itself is safe
+        const bool keepsSlot = slot != IRProgram::NONE && readAt[value] <= nextWrite[slot]
+                               && (!final[value] || ir.exits[slot] == value);
+
+        if (keepsSlot) {
+            homes[value] = slot;
+            if (writes) {
+                nextWrite[slot] = value;
+            }
+        } else {
+            homes[value] = static_cast<std::uint32_t>(program.slotNames.size());
+            program.slotNames.push_back("_" + std::to_string(value));  // Not a valid script identifier
+        }
+    }
+}
+
+/**
+ * Appends the expression computing a value with an explicit stack, so long operator chains cannot overflow it.
+ *
+ * @param value - the value to compute
+ * @return the index of the expression's root node
+ */
+std::uint32_t IRLowerer::emitExpression(const std::uint32_t value) {
+    pending.push_back(value);
+
+    while (!pending.empty()) {
+        const std::uint32_t entry = pending.back();
+        const std::uint32_t current = entry & ~EXPANDED;
+        const IROpcode opcode = ir.opcodes[current];
+        pending.pop_back();
+
+        if (opcode == IROpcode::CONST) {
+            emitted.push_back(program.appendNode(NUMBER, '\0', program.addConstant(ir.immediates[current])));
+        } else if (current != value && stored[current]) {
+            emitted.push_back(program.appendNode(IDENTIFIER, '\0', homes[current]));
+        } else if (entry & EXPANDED) {
+            const std::uint32_t rightIndex = emitted.back();
+            emitted.pop_back();
+            const std::uint32_t leftIndex = emitted.back();
+            emitted.pop_back();
+            emitted.push_back(program.appendNode(BINARY_OP, opcode == IROpcode::ADD ? '+' : '-', 0,
+                                                 leftIndex, rightIndex));
+        } else {
+            pending.push_back(current | EXPANDED);
+            pending.push_back(ir.rhs[current]);
+            pending.push_back(ir.lhs[current]);
+        }
+    }
+    const std::uint32_t index = emitted.back();
+    emitted.clear();
+    return index;
+}
+
+/**
+ * Appends an assignment for every variable whose final value is not already in it. Their sources are literals,
+ * temporaries, or variables that keep their own final value, so the order of these assignments does not matter.
+ */
+void IRLowerer::emitExits() {
+    for (std::uint32_t slot = 0; slot < ir.exits.size(); ++slot) {
+        const std::uint32_t value = ir.exits[slot];
+
+        if (value == IRProgram::NONE || homes[value] == slot) {
+            continue;
+        }
+        const std::uint32_t source = ir.opcodes[value] == IROpcode::CONST
+            ? program.appendNode(NUMBER, '\0', program.addConstant(ir.immediates[value]))
+            : program.appendNode(IDENTIFIER, '\0', homes[value]);
+        program.appendNode(ASSIGN, '\0', slot, source);
+        program.endStatement();
+    }
+}
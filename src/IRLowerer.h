@@ -0,0 +1,68 @@
+#ifndef IR_LOWERER_H
+#define IR_LOWERER_H
+
+#include <cstdint>
+#include <vector>
+#include "FlatProgram.h"
+#include "IR.h"
+
+/**
+ * The IRLowerer class turns an IRProgram back into statements over variables, as the FlatProgram every backend
+ * consumes.
+ *
+ * Values that are bound by a `let`, shown, kept as a variable's final value, or used more than once are stored in
+ * a variable; every other value is folded into the expression of its only user, and constants are always written
+ * as literals. A stored value lives in the variable it was bound to unless that variable is overwritten while the
+ * value is still needed, in which case it gets a hidden temporary variable whose name cannot clash with a script
+ * variable. Variables whose final value is not already in place are assigned at the end.
+ */
+class IRLowerer {
+public:
+    /**
+     * Initializes the lowerer with the IR to read and the flat program to fill.
+     *
+     * @param ir - the program to lower
+     * @param program - the program receiving the statements; its previous contents are replaced
+     */
+    IRLowerer(const IRProgram& ir, FlatProgram& program);
+
+    /**
+     * Lowers the whole IR program. Throws if it has 2^31 or more instructions, more than lowering can index.
+     */
+    void lower();
+
+private:
+    /**
+     * Decides which values are stored in a variable and records, for every value, the position of the statement
+     * that will read it.
+     */
+    void chooseStoredValues();
+
+    /**
+     * Chooses the variable each stored value lives in, walking backwards so that later writes are known.
+     */
+    void assignHomes();
+
+    /**
+     * Appends the expression computing a value: its operands are literals, stored values, or folded subexpressions.
+     *
+     * @param value - the value to compute
+     * @return the index of the expression's root node
+     */
+    std::uint32_t emitExpression(std::uint32_t value);
+
+    /**
+     * Appends assignments giving every variable its final value.
+     */
+    void emitExits();
+
+    const IRProgram& ir;                   // Program being lowered
+    FlatProgram& program;                  // Program being built
+    std::vector<bool> stored;              // Whether each value is stored in a variable
+    std::vector<std::uint32_t> homes;      // Variable of each stored value
+    std::vector<std::uint32_t> readAt;     // Statement position at which each stored value is last read
+    std::vector<std::uint32_t> pending;    // Explicit stack for post-order emission
+    std::vector<std::uint32_t> emitted;    // Indices of emitted subtrees awaiting their parent
+};
+
+#endif // IR_LOWERER_H
@@ -0,0 +1,66 @@
+#include "IRPrinter.h"
+#include <sstream>
+
+// Constructor initializes the printer with an IR program
+IRPrinter::IRPrinter(const IRProgram& ir) : ir(ir) {}
+
+/**
+ * Prints the program. Instructions bound by a `let` are annotated with their variable, and shows with the
+ * variable they name.
+ *
+ * @param out - stream receiving the text
+ */
+void IRPrinter::print(std::ostream& out) const {
+    std::ostringstream line;
+
+    for (std::uint32_t value = 0; value < ir.size(); ++value) {
+        line.str("");
+        printInstruction(line, value);
+        out << line.str();
+
+        const std::uint32_t slot = ir.slots[value];
+        if (slot != IRProgram::NONE && ir.opcodes[value] != IROpcode::INPUT) {
+            const std::size_t width = line.str().size();
+
+            out << std::string(width < 30 ? 30 - width : 1, ' ') << "; "
+                << (ir.opcodes[value] == IROpcode::SHOW ? "" : "let ") << ir.slotNames[slot];
+        }
+        out << "\n";
+    }
+
+    const char* separator = "exit ";
+    for (std::size_t slot = 0; slot < ir.exits.size(); ++slot) {
+        if (ir.exits[slot] != IRProgram::NONE) {
+            out << separator << ir.slotNames[slot] << " = %" << ir.exits[slot];
+            separator = ", ";
+        }
+    }
+    if (*separator == ',') {
+        out << "\n";
+    }
+}
+
+/**
+ * Prints a single instruction.
+ *
+ * @param out - stream receiving the text
+ * @param value - the instruction
+ */
+void IRPrinter::printInstruction(std::ostream& out, const std::uint32_t value) const {
+    switch (ir.opcodes[value]) {
+        case IROpcode::CONST:
+            out << "%" << value << " = const i64 " << ir.immediates[value];
+            break;
+        case IROpcode::INPUT:
+            out << "%" << value << " = input i64 " << ir.slotNames[ir.slots[value]];
+            break;
+        case IROpcode::ADD:
+        case IROpcode::SUB:
+            out << "%" << value << " = " << (ir.opcodes[value] == IROpcode::ADD ? "add" : "sub") << " i64 %"
+                << ir.lhs[value] << ", %" << ir.rhs[value];
+            break;
+        case IROpcode::SHOW:
+            out << "show %" << ir.lhs[value];
+            break;
+    }
+}
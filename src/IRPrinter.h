@@ -0,0 +1,44 @@
+#ifndef IR_PRINTER_H
+#define IR_PRINTER_H
+
+#include <cstdint>
+#include <ostream>
+#include "IR.h"
+
+/**
+ * The IRPrinter class writes an IRProgram as text, one instruction per line, for `--emit-ir`.
+ *
+ *     %0 = const i64 5              ; let a
+ *     %1 = add i64 %0, %0           ; let b
+ *     show %1                       ; b
+ *     exit a = %0, b = %1
+ */
+class IRPrinter {
+public:
+    /**
+     * Initializes the printer with a reference to an IR program.
+     *
+     * @param ir - the program to print
+     */
+    explicit IRPrinter(const IRProgram& ir);
+
+    /**
+     * Prints every instruction, then the final value of each variable that keeps one.
+     *
+     * @param out - stream receiving the text
+     */
+    void print(std::ostream& out) const;
+
+private:
+    /**
+     * Prints a single instruction without its trailing comment.
+     *
+     * @param out - stream receiving the text
+     * @param value - the instruction
+     */
+    void printInstruction(std::ostream& out, std::uint32_t value) const;
+
+    const IRProgram& ir;  // Reference to the program to be printed
+};
+
+#endif // IR_PRINTER_H
@@ -0,0 +1,90 @@
+#include "IRVerifier.h"
+#include <stdexcept>
+
+// Constructor initializes the verifier with the program to check
+IRVerifier::IRVerifier(const IRProgram& ir) : ir(ir) {}
+
+/**
+ * Checks every instruction in order, then the final values of the variables.
+ */
+void IRVerifier::verify() const {
+    const std::size_t size = ir.size();
+
+    if (ir.lhs.size() != size || ir.rhs.size() != size || ir.immediates.size() != size || ir.slots.size() != size
+        || ir.exits.size() != ir.slotNames.size()) {
+        throw std::runtime_error("Invalid IR: instruction arrays have different lengths");
+    }
+
+    for (std::uint32_t i = 0; i < size; ++i) {
+        switch (ir.opcodes[i]) {
+            case IROpcode::CONST:
+            case IROpcode::INPUT:
+                if (ir.lhs[i] != IRProgram::NONE || ir.rhs[i] != IRProgram::NONE) {
+                    fail(i, "constants and inputs take no operands");
+                }
+                checkSlot(i, ir.slots[i], ir.opcodes[i] == IROpcode::CONST);
+                break;
+            case IROpcode::ADD:
+            case IROpcode::SUB:
+                checkOperand(i, ir.lhs[i]);
+                checkOperand(i, ir.rhs[i]);
+                checkSlot(i, ir.slots[i], true);
+                break;
+            case IROpcode::SHOW:
+                checkOperand(i, ir.lhs[i]);
+                if (ir.rhs[i] != IRProgram::NONE) {
+                    fail(i, "show takes one operand");
+                }
+                checkSlot(i, ir.slots[i], false);
+                break;
+            default:
+                fail(i, "unknown opcode");
+        }
+    }
+
+    for (std::size_t slot = 0; slot < ir.exits.size(); ++slot) {
+        const std::uint32_t value = ir.exits[slot];
+
+        if (value != IRProgram::NONE && (value >= size || ir.typeOf(value) != IRType::I64)) {
+            throw std::runtime_error("Invalid IR: final value of " + ir.slotNames[slot] + " is not a defined value");
+        }
+    }
+}
+
+/**
+ * Checks that an operand is defined before its use and has a value.
+ *
+ * @param instruction - the instruction using the operand
+ * @param operand - the operand
+ */
+void IRVerifier::checkOperand(const std::uint32_t instruction, const std::uint32_t operand) const {
+    if (operand == IRProgram::NONE || operand >= instruction) {
+        fail(instruction, "operand is not defined before its use");
+    }
+    if (ir.typeOf(operand) != IRType::I64) {
+        fail(instruction, "operand %" + std::to_string(operand) + " has no value");
+    }
+}
+
+/**
+ * Checks that a variable reference is in range.
+ *
+ * @param instruction - the instruction referring to the variable
+ * @param slot - the variable
+ * @param optional - whether NONE is allowed
+ */
+void IRVerifier::checkSlot(const std::uint32_t instruction, const std::uint32_t slot, const bool optional) const {
+    if (slot == IRProgram::NONE ? !optional : slot >= ir.slotNames.size()) {
+        fail(instruction, "invalid variable");
+    }
+}
+
+/**
+ * Throws the error for an instruction.
+ *
+ * @param instruction - the offending instruction
+ * @param message - what is wrong with it
+ */
+void IRVerifier::fail(const std::uint32_t instruction, const std::string& message) {
+    throw std::runtime_error("Invalid IR at %" + std::to_string(instruction) + ": " + message);
+}
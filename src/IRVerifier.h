@@ -0,0 +1,56 @@
+#ifndef IR_VERIFIER_H
+#define IR_VERIFIER_H
+
+#include <cstdint>
+#include <string>
+#include "IR.h"
+
+/**
+ * The IRVerifier class checks the structural rules of an IRProgram: every operand names an earlier instruction
+ * that has a value, each operation has exactly the operands it needs, and every variable reference is in range.
+ * It runs after the IR is built and after each pass, so a broken transformation is caught before any backend.
+ */
+class IRVerifier {
+public:
+    /**
+     * Initializes the verifier with a reference to the program to check.
+     *
+     * @param ir - the program to check
+     */
+    explicit IRVerifier(const IRProgram& ir);
+
+    /**
+     * Checks the program, throwing a std::runtime_error that names the first offending instruction.
+     */
+    void verify() const;
+
+private:
+    /**
+     * Checks that an operand names an earlier instruction with an i64 result.
+     *
+     * @param instruction - the instruction using the operand
+     * @param operand - the operand
+     */
+    void checkOperand(std::uint32_t instruction, std::uint32_t operand) const;
+
+    /**
+     * Checks that a variable reference is in range.
+     *
+     * @param instruction - the instruction referring to the variable
+     * @param slot - the variable
+     * @param optional - whether NONE is allowed
+     */
+    void checkSlot(std::uint32_t instruction, std::uint32_t slot, bool optional) const;
+
+    /**
+     * Throws the error for an instruction.
+     *
+     * @param instruction - the offending instruction
+     * @param message - what is wrong with it
+     */
+    [[noreturn]] static void fail(std::uint32_t instruction, const std::string& message);
+
+    const IRProgram& ir;  // Reference to the program to be checked
+};
+
+#endif // IR_VERIFIER_H
@@ -1,87 +1,187 @@
 #include "Interpreter.h"
-#include <iostream>
-#include <stdexcept>
-#include <memory>
+#include <algorithm>
+#include <future>
 
-// Constructor initializes the interpreter with a reference to AST nodes
-Interpreter::Interpreter(const std::vector<std::unique_ptr<ASTNode>>& nodes) : ast(nodes) {}
+// Constructor initializes the interpreter with the program, its output, and an optional pool
+Interpreter::Interpreter(const FlatProgram& program, OutputBuffer& output, ThreadPool* pool)
+    : program(program), output(output), pool(pool) {}
 
 /**
- * Executes the AST by processing each node sequentially.
- * Calls executeNode on each node in the AST to perform actions.
+ * Executes the program by running each statement in order.
+ * Variable values persist across calls, so a program that is cleared and refilled between calls
+ * (as when streaming) continues from the previous state.
  */
 void Interpreter::execute() {
-    for (const auto& node : ast) {
-        executeNode(*node);  // Execute each AST node
+    // Make room for slots and statements added since the last call; existing values are kept
+    if (slots.size() < program.slotNames.size()) {
+        slots.resize(program.slotNames.size());
+    }
+    if (values.size() < program.maxStatementSize) {
+        values.resize(program.maxStatementSize);
+    }
+    std::uint32_t start = 0;
+
+    for (const std::uint32_t root : program.statements) {
+        const bool parallel = pool && root - start >= PARALLEL_THRESHOLD && program.kinds[root] == ASSIGN;
+
+        if (!parallel || !executeReduction(start, root)) {
+            executeStatement(start, root);
+        }
+        start = root + 1;
     }
 }
 
 /**
- * Executes a single AST node based on its type (e.g., assignment, print).
+ * Executes a single statement.
+ * Nodes are in post-order, so each node's operands have already been evaluated when it is reached.
  *
- * @param node - AST node to be executed
+ * @param start - index of the statement's first node
+ * @param root - index of the statement's ASSIGN or PRINT node
  */
-void Interpreter::executeNode(const ASTNode& node) {
-    if (node.type == ASSIGN) {
-        // For assignment nodes, evaluate the right-hand expression and store the result
-        if (node.children.size() == 1) {
-            variables[node.value] = evaluateExpression(*node.children[0]);
+void Interpreter::executeStatement(const std::uint32_t start, const std::uint32_t root) {
+    const NodeType* kinds = program.kinds.data();
+    const std::uint32_t* operands = program.operands.data();
+    const std::uint32_t* left = program.left.data();
+    const std::uint32_t* right = program.right.data();
+    Value* local = values.data();  // Indexed by node index relative to start
+
+    for (std::uint32_t i = start; i <= root; ++i) {
+        switch (kinds[i]) {
+            case NUMBER:
+                local[i - start] = program.constants[operands[i]];
+                break;
+            case IDENTIFIER:
+                local[i - start] = slots[operands[i]];  // Return the stored value of the identifier
+                break;
+            case BINARY_OP:
+                // Perform the operation based on the operator type
+                local[i - start] = program.ops[i] == '+'
+                                       ? wrappingAdd(local[left[i] - start], local[right[i] - start])
+                                       : wrappingSub(local[left[i] - start], local[right[i] - start]);
+                break;
+            case ASSIGN:
+                slots[operands[i]] = local[left[i] - start];
+                break;
+            case PRINT:
+                performPrint(operands[i]);
+                break;
         }
-    } else if (node.type == PRINT) {
-        performPrint(node);  // Handle print operation
     }
 }
 
 /**
- * Evaluates an expression node and returns its integer result.
- * Supports identifiers, numeric literals, and binary operations.
+ * Sums an assignment's expression in chunks. In post-order, a chain whose operations all have a literal or
+ * variable as their right operand starts with its leftmost leaf, and every other leaf is the right operand of
+ * exactly one operation, added or subtracted by it; the chain's value is therefore the leftmost leaf plus the
+ * signed right operand of each operation, in any order.
  *
- * @param node - AST node representing an expression
- * @return - integer result of the expression
+ * The chunks are checked in a first pass and summed in a second, so an expression that is not such a chain
+ * costs one parallel scan before it is executed sequentially, not a parallel sum that is thrown away.
+ *
+ * Only unoptimized programs get here. Every value a script computes is known before it runs, so from
+ * optimization level 1 constant folding and propagation leave each assignment a single literal, which is far
+ * below PARALLEL_THRESHOLD; at level 0 lowering rebuilds each source expression as the same left-deep chain.
+ *
+ * @param start - index of the statement's first node
+ * @param root - index of the statement's ASSIGN node
+ * @return true if the statement was executed, false if the expression is not such a chain
  */
-int Interpreter::evaluateExpression(const ASTNode& node) {
-    if (node.type == IDENTIFIER) {
-        // Check if the identifier has been defined
-        if (variables.find(node.value) == variables.end()) {
-            throw std::runtime_error("Undefined variable: " + node.value);
+bool Interpreter::executeReduction(const std::uint32_t start, const std::uint32_t root) {
+    const std::uint32_t first = start + 1;  // Nodes after the leftmost leaf, up to the ASSIGN
+    const std::size_t chunkCount = pool->size() * CHUNKS_PER_THREAD;
+    const std::uint32_t chunkSize = static_cast<std::uint32_t>((root - first + chunkCount - 1) / chunkCount);
+    std::vector<Value> partials(chunkCount, 0);
+    std::atomic<bool> nested{false};
+
+    // Runs a task on the pool for every chunk's range of nodes and waits for all of them
+    const auto forEachChunk = [&](const auto& task) {
+        std::vector<std::future<void>> pending;
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            const std::uint32_t begin =
+                first + static_cast<std::uint32_t>(std::min<std::size_t>(chunk * chunkSize, root - first));
+            const std::uint32_t end = std::min(begin + chunkSize, root);
+            pending.push_back(pool->submit([&task, chunk, begin, end] { task(chunk, begin, end); }));
         }
-        return variables[node.value];  // Return the stored value of the identifier
+        for (std::future<void>& result : pending) {
+            result.get();
+        }
+    };
+
+    forEachChunk([this, &nested](std::size_t, const std::uint32_t begin, const std::uint32_t end) {
+        checkTerms(begin, end, nested);
+    });
+    if (nested) {
+        return false;
     }
+    forEachChunk([this, &partials](const std::size_t chunk, const std::uint32_t begin, const std::uint32_t end) {
+        partials[chunk] = sumTerms(begin, end);
+    });
 
-    if (node.type == NUMBER) {
-        // Convert the numeric string to an integer
-        return std::stoi(node.value);
+    Value sum = program.kinds[start] == NUMBER ? program.constants[program.operands[start]]
+                                               : slots[program.operands[start]];
+    for (const Value partial : partials) {
+        sum = wrappingAdd(sum, partial);
     }
+    slots[program.operands[root]] = sum;
+    return true;
+}
 
-    if (node.type == BINARY_OP) {
-        // For binary operations, evaluate both the left and right expressions
-        const auto* binOpNode = dynamic_cast<const BinaryOpNode*>(&node);
-        const int leftValue = evaluateExpression(*binOpNode->children[0]);
-        const int rightValue = evaluateExpression(*binOpNode->children[1]);
+/**
+ * Checks the right operand of every operation in a range, looking every CHECK_INTERVAL nodes whether another
+ * range has already failed.
+ *
+ * @param begin - index of the first node of the range
+ * @param end - index one past the last node of the range
+ * @param nested - set if an operation's right operand is not a literal or variable
+ */
+void Interpreter::checkTerms(const std::uint32_t begin, const std::uint32_t end, std::atomic<bool>& nested) const {
+    const NodeType* kinds = program.kinds.data();
+    const std::uint32_t* right = program.right.data();
 
-        // Perform the operation based on the operator type
-        if (binOpNode->op == '+') {
-            return leftValue + rightValue;
+    for (std::uint32_t i = begin; i < end; ++i) {
+        if ((i - begin) % CHECK_INTERVAL == 0 && nested.load(std::memory_order_relaxed)) {
+            return;
         }
-        if (binOpNode->op == '-') {
-            return leftValue - rightValue;
+        if (kinds[i] == BINARY_OP && kinds[right[i]] != NUMBER && kinds[right[i]] != IDENTIFIER) {
+            nested = true;
+            return;
         }
     }
-    // If the expression node type is unrecognized, throw an error
-    throw std::runtime_error("Invalid expression node type.");
 }
 
 /**
- * Performs the print operation for PRINT nodes by outputting the variable value.
+ * Sums the right operands of the operations in a range of nodes; the leaves in the range are read through
+ * their operations.
  *
- * @param node - AST node representing a print operation
+ * @param begin - index of the first node of the range
+ * @param end - index one past the last node of the range
+ * @return the wrapped partial sum
  */
-void Interpreter::performPrint(const ASTNode& node) {
-    if (variables.find(node.value) != variables.end()) {
-        // Output the stored value of the variable
-        std::cout << "Result: " << variables[node.value] << std::endl;
-    } else {
-        // Throw an error if the variable is not defined
-        throw std::runtime_error("Undefined variable: " + node.value);
+Value Interpreter::sumTerms(const std::uint32_t begin, const std::uint32_t end) const {
+    const NodeType* kinds = program.kinds.data();
+    const std::uint32_t* operands = program.operands.data();
+    const std::uint32_t* right = program.right.data();
+    const Value* constants = program.constants.data();
+    const Value* variables = slots.data();
+    Value sum = 0;
+
+    for (std::uint32_t i = begin; i < end; ++i) {
+        if (kinds[i] != BINARY_OP) {
+            continue;
+        }
+        const std::uint32_t term = right[i];
+        const Value value = kinds[term] == NUMBER ? constants[operands[term]] : variables[operands[term]];
+        sum = program.ops[i] == '+' ? wrappingAdd(sum, value) : wrappingSub(sum, value);
     }
+    return sum;
+}
+
+/**
+ * Performs the print operation by outputting the variable value.
+ *
+ * @param slot - slot of the variable to print
+ */
+void Interpreter::performPrint(const std::uint32_t slot) {
+    // Output the stored value of the variable
+    output.writeResult(slots[slot]);
 }
@@ -1,54 +1,92 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
+#include <atomic>
 #include <vector>
-#include <unordered_map>
-#include "AST.h"
-#include <memory>
+#include "FlatProgram.h"
+#include "OutputBuffer.h"
+#include "ThreadPool.h"
 
 /**
- * Interpreter class is responsible for executing an Abstract Syntax Tree (AST).
- * It processes each node in the AST, handling assignments, print operations, and expressions.
+ * Interpreter class is responsible for executing a program.
+ * It works on the flat, post-order FlatProgram, so each statement is evaluated by a forward scan over
+ * its nodes, with variables read straight from their slots.
+ *
+ * Given a thread pool, an assignment whose expression is a large chain of additions and subtractions is summed
+ * in parallel instead: each worker adds up the terms in one range of the chain's nodes, and the partial sums are
+ * combined. Values wrap on overflow, so the result is bit-identical to the sequential sum.
  */
 class Interpreter {
 public:
     /**
-     * Initializes the interpreter with a reference to a vector of AST nodes.
+     * Initializes the interpreter with a reference to a flat program.
      *
-     * @param nodes - the AST nodes representing the program structure to be executed
+     * @param program - the program to be executed
+     * @param output - the buffer receiving printed values
+     * @param pool - the pool that sums large expressions in parallel, or null to run everything on this thread
      */
-    explicit Interpreter(const std::vector<std::unique_ptr<ASTNode>>& nodes);
+    Interpreter(const FlatProgram& program, OutputBuffer& output, ThreadPool* pool = nullptr);
 
     /**
-     * Executes the AST by processing each node in sequence.
+     * Executes the program by processing each statement in sequence.
+     * Variables keep their values between calls.
      */
     void execute();
 
 private:
-    std::unordered_map<std::string, int> variables;  // Stores variable values for assignment operations
-    const std::vector<std::unique_ptr<ASTNode>>& ast;  // Reference to AST nodes to be interpreted
+    static constexpr std::uint32_t PARALLEL_THRESHOLD = 1 << 16;  // Statement size, in nodes, worth splitting
+    static constexpr std::size_t CHUNKS_PER_THREAD = 4;            // Chunks per worker, so uneven ones still balance
+    static constexpr std::uint32_t CHECK_INTERVAL = 4096;          // Nodes checked between looks at other chunks
+
+    const FlatProgram& program;  // Reference to the program to be interpreted
+    OutputBuffer& output;        // Buffer receiving printed values
+    ThreadPool* pool;            // Pool for parallel sums, or null
+    std::vector<Value> slots;    // Stores variable values, indexed by slot
+    std::vector<Value> values;   // Value of each node of the current statement, indexed from its first node
+
+    /**
+     * Executes a single statement by evaluating its nodes in order.
+     *
+     * @param start - index of the statement's first node
+     * @param root - index of the statement's ASSIGN or PRINT node
+     */
+    void executeStatement(std::uint32_t start, std::uint32_t root);
+
+    /**
+     * Executes an assignment of a left-deep chain of additions and subtractions by summing its terms on the pool.
+     * The chain's shape is checked on the pool before anything is summed; anything else is left to
+     * executeStatement, so no statement is evaluated twice.
+     *
+     * @param start - index of the statement's first node
+     * @param root - index of the statement's ASSIGN node
+     * @return true if the statement was executed
+     */
+    bool executeReduction(std::uint32_t start, std::uint32_t root);
 
     /**
-     * Executes a single AST node based on its type (e.g., assignment, print).
+     * Checks that every operation in a range of nodes has a literal or variable as its right operand.
      *
-     * @param node - AST node to be executed
+     * @param begin - index of the first node of the range
+     * @param end - index one past the last node of the range
+     * @param nested - set when a range fails the check; a range stops checking once it sees it set
      */
-    void executeNode(const ASTNode& node);
+    void checkTerms(std::uint32_t begin, std::uint32_t end, std::atomic<bool>& nested) const;
 
     /**
-     * Evaluates an expression node and returns its integer result.
+     * Sums the terms that the operations in a range of nodes add or subtract. The range must pass checkTerms.
      *
-     * @param node - AST node representing an expression
-     * @return - integer result of the expression
+     * @param begin - index of the first node of the range
+     * @param end - index one past the last node of the range
+     * @return the wrapped partial sum
      */
-    int evaluateExpression(const ASTNode& node);
+    Value sumTerms(std::uint32_t begin, std::uint32_t end) const;
 
     /**
-     * Performs a print operation for PRINT nodes, outputting the value of a variable.
+     * Performs a print operation, outputting the value of a variable.
      *
-     * @param node - AST node representing a print operation
+     * @param slot - slot of the variable to print
      */
-    void performPrint(const ASTNode& node);
+    void performPrint(std::uint32_t slot);
 };
 
 #endif // INTERPRETER_H
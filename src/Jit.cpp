@@ -0,0 +1,71 @@
+#include "Jit.h"
+#include "Compiler.h"
+#include "X86Encoder.h"
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#include <sys/mman.h>
+#define LITESCRIPT_JIT 1
+#endif
+
+// Constructor initializes the JIT with a flat program and its output
+Jit::Jit(const FlatProgram& program, OutputBuffer& output) : program(program), output(output) {}
+
+/**
+ * Checks whether the host can run JIT-compiled code.
+ *
+ * @return true on x86-64 POSIX hosts
+ */
+bool Jit::isSupported() {
+#ifdef LITESCRIPT_JIT
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Generates and encodes the program, maps it executable, and calls it with the slot array.
+ * The mapping is filled while writable and only then switched to read-and-execute.
+ */
+void Jit::execute() {
+#ifdef LITESCRIPT_JIT
+    slots.resize(program.slotNames.size(), 0);
+
+    Compiler compiler(program);
+    const MachineProgram machine = compiler.generateFunction(reinterpret_cast<std::uint64_t>(&Jit::printValue),
+                                                                reinterpret_cast<std::uint64_t>(&output));
+    X86Encoder encoder(machine);
+    encoder.encode();
+    encoder.link(0, {});  // Functions reference no data symbols
+
+    const std::vector<std::uint8_t>& code = encoder.code();
+    void* memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("Could not map memory for JIT code");
+    }
+    std::memcpy(memory, code.data(), code.size());
+    if (mprotect(memory, code.size(), PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, code.size());
+        throw std::runtime_error("Could not make JIT code executable");
+    }
+
+    const auto function = reinterpret_cast<void (*)(Value*)>(static_cast<std::uint8_t*>(memory) + encoder.labelOffset(machine.entry));
+    function(slots.data());
+    munmap(memory, code.size());
+#else
+    throw std::runtime_error("JIT execution is not supported on this platform");
+#endif
+}
+
+/**
+ * Prints a value, called from the generated code for every show statement.
+ *
+ * @param output - the OutputBuffer receiving the value
+ * @param value - the value to print
+ */
+void Jit::printValue(void* output, const Value value) noexcept {
+    static_cast<OutputBuffer*>(output)->writeResult(value);
+}
@@ -0,0 +1,54 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <vector>
+#include "FlatProgram.h"
+#include "OutputBuffer.h"
+
+/**
+ * The Jit class runs a FlatProgram as native x86-64 code generated in memory.
+ *
+ * The Compiler generates the program as a function over the variable slots, the X86Encoder encodes it, and the
+ * bytes are copied into an anonymous mapping that is made executable (never writable and executable at once)
+ * and called directly. Variable slots live in an array owned by the Jit, and prints call back into the host,
+ * which appends to the same OutputBuffer as the other engines.
+ */
+class Jit {
+public:
+    /**
+     * Initializes the JIT with a reference to a flat program.
+     *
+     * @param program - the program to be executed
+     * @param output - the buffer receiving printed values
+     */
+    Jit(const FlatProgram& program, OutputBuffer& output);
+
+    /**
+     * Checks whether the host can run JIT-compiled code: an x86-64 POSIX system.
+     *
+     * @return true if execute() is available
+     */
+    [[nodiscard]] static bool isSupported();
+
+    /**
+     * Compiles the program to machine code and runs it. Variables keep their values between calls.
+     * Throws if the host is not supported or executable memory cannot be mapped.
+     */
+    void execute();
+
+private:
+    /**
+     * Prints a value the way the Interpreter does; called from the generated code. Never throws, since
+     * exceptions cannot unwind through the generated code.
+     *
+     * @param output - the OutputBuffer receiving the value
+     * @param value - the value to print
+     */
+    static void printValue(void* output, Value value) noexcept;
+
+    const FlatProgram& program;  // Reference to the program to be executed
+    OutputBuffer& output;        // Buffer receiving printed values
+    std::vector<Value> slots;    // Stores variable values, indexed by slot
+};
+
+#endif // JIT_H
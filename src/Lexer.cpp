@@ -1,58 +1,65 @@
 #include "Lexer.h"
-#include <cctype>
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
+#include "Scanner.h"
 
-// Constructor initializes the Lexer with the source code to tokenize
-Lexer::Lexer(std::string source) : source(std::move(source)) {}
+// Constructor initializes the Lexer with a view of the source code to tokenize and its starting line
+Lexer::Lexer(const std::string_view source, const std::uint32_t firstLine) : source(source), line(firstLine) {}
 
 /**
  * Tokenizes the source code into a vector of tokens.
  *
- * Reads through each character, identifies token types, and adds tokens to the list.
+ * Reads tokens one at a time until the END token, which is included.
  * @return a vector of tokens
  */
 std::vector<Token> Lexer::tokenize() {
     std::vector<Token> tokens;
 
-    while (!isAtEnd()) {
-        skipWhitespace();  // Skip any whitespace between tokens
-        if (isAtEnd()) break;
+    do {
+        tokens.push_back(next());
+    } while (tokens.back().type != TokenType::END);
+    return tokens;
+}
+
+/**
+ * Produces the next token in the source code.
+ *
+ * Skips whitespace, identifies the token type at the current position, and advances past it.
+ * @return the next token, or an END token once the source is exhausted
+ */
+Token Lexer::next() {
+    skipWhitespace();  // Skip any whitespace before the token
+    if (isAtEnd()) return {TokenType::END, "", line};
 
-        const char c = peek();
+    const char c = peek();
+    Token token{};
 
-        // Match keywords and literals
-        if (c == 'l' && matchKeyword("let", TokenType::LET, tokens)) continue;
-        if (c == 's' && matchKeyword("show", TokenType::SHOW, tokens)) continue;
-        if (isdigit(c)) {
-            // Tokenize a number
-            const std::string number = consumeNumber();
-            tokens.push_back({TokenType::NUMBER, number});
-        } else if (isalpha(c)) {
-            // Tokenize an identifier
-            const std::string id = consumeIdentifier();
-            tokens.push_back({TokenType::IDENTIFIER, id});
-        } else {
-            // Tokenize symbols and throw error for unknown characters
-            if (c == '+') {
-                tokens.push_back({TokenType::PLUS, "+"});
-                advance();
-            } else if (c == '-') {
-                tokens.push_back({TokenType::MINUS, "-"});
-                advance();
-            } else if (c == '=') {
-                tokens.push_back({TokenType::EQUALS, "="});
-                advance();
-            } else if (c == ';') {
-                tokens.push_back({TokenType::SEMICOLON, ";"});
-                advance();
-            } else {
-                throw std::runtime_error("Invalid character: " + std::string(1, c));
-            }
-        }
+    // Match keywords and literals
+    if (c == 'l' && matchKeyword("let", TokenType::LET, token)) return token;
+    if (c == 's' && matchKeyword("show", TokenType::SHOW, token)) return token;
+    if (isAsciiDigit(c)) {
+        // Tokenize a number
+        return {TokenType::NUMBER, consumeNumber(), line};
     }
-    tokens.push_back({TokenType::END, ""});
-    return tokens;
+    if (isAsciiAlpha(c)) {
+        // Tokenize an identifier
+        return {TokenType::IDENTIFIER, consumeIdentifier(), line};
+    }
+    // Tokenize symbols and throw error for unknown characters
+    if (c == '+') {
+        token = {TokenType::PLUS, source.substr(current, 1), line};
+    } else if (c == '-') {
+        token = {TokenType::MINUS, source.substr(current, 1), line};
+    } else if (c == '=') {
+        token = {TokenType::EQUALS, source.substr(current, 1), line};
+    } else if (c == ';') {
+        token = {TokenType::SEMICOLON, source.substr(current, 1), line};
+    } else {
+        throw std::runtime_error("Invalid character: " + std::string(1, c) + " at line " + std::to_string(line));
+    }
+    advance();
+    return token;
 }
 
 /**
@@ -75,47 +82,52 @@ char Lexer::peek() const {
 
 /**
  * Consumes a sequence of digits as a number.
- * Reads characters while they are digits and returns them as a string.
+ * Scans to the end of the digit run and returns a view of it.
  *
  * @return the numeric string
  */
-std::string Lexer::consumeNumber() {
-    std::string number;
-    while (isdigit(peek())) number += advance();
-    return number;
+std::string_view Lexer::consumeNumber() {
+    const size_t start = current;
+    current = scanDigits(source.data(), current, source.length());
+    return source.substr(start, current - start);
 }
 
 /**
  * Consumes a sequence of alphabetic characters as an identifier.
- * Reads characters while they are alphabetic and returns them as a string.
+ * Scans to the end of the letter run and returns a view of it.
  *
  * @return the identifier string
  */
-std::string Lexer::consumeIdentifier() {
-    std::string id;
-    while (isalpha(peek())) id += advance();
-    return id;
+std::string_view Lexer::consumeIdentifier() {
+    const size_t start = current;
+    current = scanAlpha(source.data(), current, source.length());
+    return source.substr(start, current - start);
 }
 
 /**
  * Skips whitespace characters in the source code by advancing the position.
+ * Newlines can only occur in whitespace, so this is also where the line number is kept up to date.
  */
 void Lexer::skipWhitespace() {
-    while (!isAtEnd() && isspace(peek())) advance();
+    const size_t start = current;
+    current = scanWhitespace(source.data(), current, source.length());
+    line += static_cast<std::uint32_t>(std::count(source.data() + start, source.data() + current, '\n'));
 }
 
 /**
- * Matches a specified keyword in the source code and adds it as a token if found.
+ * Matches a specified keyword in the source code and stores it as a token if found.
  * Ensures the keyword is followed by a non-alphanumeric character to avoid partial matches.
  *
  * @param keyword - the keyword to match in the source code
  * @param type - the token type assigned if the keyword matches
- * @param tokens - the vector of tokens to add to if a match is found
+ * @param token - the token to fill in if a match is found
  * @return true if the keyword matches, false otherwise
  */
-bool Lexer::matchKeyword(const std::string& keyword, const TokenType type, std::vector<Token>& tokens) {
-    if (source.substr(current, keyword.length()) == keyword && !isalnum(peekAt(current + keyword.length()))) {
-        tokens.push_back({type, keyword});
+bool Lexer::matchKeyword(const std::string_view keyword, const TokenType type, Token& token) {
+    const char following = peekAt(current + keyword.length());
+
+    if (source.substr(current, keyword.length()) == keyword && !isAsciiAlpha(following) && !isAsciiDigit(following)) {
+        token = {type, source.substr(current, keyword.length()), line};
         current += keyword.length();  // Advance past the matched keyword
         return true;
     }
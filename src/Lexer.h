@@ -1,7 +1,9 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -12,11 +14,13 @@ enum class TokenType {
 };
 
 /**
- * Struct representing a token with its type and lexeme (string representation).
+ * Struct representing a token with its type, lexeme (string representation) and source line.
+ * The lexeme is a view into the source the Lexer was given, so tokens are only valid while that source is.
  */
 struct Token {
     TokenType type;
-    std::string lexeme;
+    std::string_view lexeme;
+    std::uint32_t line;
 };
 
 /**
@@ -27,9 +31,11 @@ class Lexer {
 public:
     /**
      * Initializes the lexer with the source string to tokenize.
+     * The source is not copied and must outlive the lexer and every token it produces.
      * @param source - the source code as a string
+     * @param firstLine - line number of the first character, for sources that are a slice of a larger file
      */
-    explicit Lexer(std::string source);
+    explicit Lexer(std::string_view source, std::uint32_t firstLine = 1);
 
     /**
      * Tokenizes the source string, returning a vector of recognized tokens.
@@ -37,9 +43,16 @@ public:
      */
     std::vector<Token> tokenize();
 
+    /**
+     * Produces the next token on demand, so a caller can lex without holding the whole token vector.
+     * @return - the next token, or an END token once the source is exhausted
+     */
+    Token next();
+
 private:
-    std::string source;  // Source code to tokenize
+    std::string_view source;  // Source code to tokenize
     size_t current = 0;  // Current position in the source code
+    std::uint32_t line;  // Line number at the current position
 
     /**
      * Advances the lexer by one character and returns it.
@@ -76,29 +89,29 @@ private:
     void skipWhitespace();
 
     /**
-     * Consumes a sequence of numeric characters and returns them as a string.
+     * Consumes a sequence of numeric characters and returns them as a view into the source.
      *
      * @return - the consumed number as a string
      */
-    std::string consumeNumber();
+    std::string_view consumeNumber();
 
     /**
      * Consumes a sequence of alphabetic characters, forming an identifier.
      *
-     * @return - the consumed identifier as a string
+     * @return - the consumed identifier as a view into the source
      */
-    std::string consumeIdentifier();
+    std::string_view consumeIdentifier();
 
     /**
      * Matches a specific keyword if present at the current position.
-     * Adds the token to the provided token vector if matched.
+     * Stores the matched token in the provided token.
      *
      * @param keyword - the keyword to match
      * @param type - token type to use if matched
-     * @param tokens - vector to add the matched token
+     * @param token - token to fill in if matched
      * @return - true if the keyword was matched; false otherwise
      */
-    bool matchKeyword(const std::string& keyword, TokenType type, std::vector<Token>& tokens);
+    bool matchKeyword(std::string_view keyword, TokenType type, Token& token);
 };
 
 #endif // LEXER_H
@@ -0,0 +1,54 @@
+#include "LinearEvaluator.h"
+
+// Constructor initializes the evaluator with the program to evaluate
+LinearEvaluator::LinearEvaluator(const IRProgram& ir) : ir(ir) {}
+
+/**
+ * Walks the instructions in order. A constant is a form without terms, an input is the form 1 * input, and an
+ * addition or subtraction merges the forms of its operands.
+ *
+ * @return one form per show, in program order
+ */
+std::vector<LinearForm> LinearEvaluator::evaluate() const {
+    const std::uint32_t size = ir.size();
+    std::vector<std::uint32_t> lastUse(size, IRProgram::NONE);
+
+    for (std::uint32_t value = 0; value < size; ++value) {
+        if (ir.lhs[value] != IRProgram::NONE) {
+            lastUse[ir.lhs[value]] = value;
+        }
+        if (ir.rhs[value] != IRProgram::NONE) {
+            lastUse[ir.rhs[value]] = value;
+        }
+    }
+
+    std::vector<LinearForm> forms(size);
+    std::vector<LinearForm> shown;
+
+    for (std::uint32_t value = 0; value < size; ++value) {
+        switch (ir.opcodes[value]) {
+            case IROpcode::CONST:
+                forms[value].constant = ir.immediates[value];
+                break;
+            case IROpcode::INPUT:
+                forms[value].terms.emplace_back(ir.slots[value], 1);
+                break;
+            case IROpcode::ADD:
+            case IROpcode::SUB:
+                forms[value] = LinearForm::combine(forms[ir.lhs[value]], forms[ir.rhs[value]],
+                                                   ir.opcodes[value] == IROpcode::SUB);
+                break;
+            case IROpcode::SHOW:
+                shown.push_back(forms[ir.lhs[value]]);
+                break;
+        }
+
+        // Release the terms of operands nothing reads again
+        for (const std::uint32_t operand : {ir.lhs[value], ir.rhs[value]}) {
+            if (operand != IRProgram::NONE && lastUse[operand] == value) {
+                std::vector<std::pair<std::uint32_t, Value>>().swap(forms[operand].terms);
+            }
+        }
+    }
+    return shown;
+}
@@ -0,0 +1,36 @@
+#ifndef LINEAR_EVALUATOR_H
+#define LINEAR_EVALUATOR_H
+
+#include <vector>
+#include "IR.h"
+#include "LinearForm.h"
+
+/**
+ * The LinearEvaluator class evaluates a program symbolically. LiteScript only adds and subtracts integers, so
+ * every value is a linear form over the script's inputs; a program without inputs reduces to constants.
+ *
+ * One forward pass computes the form of every value from the forms of its operands, in O(instructions) times
+ * the number of inputs a form mentions. Forms are released after their last use, so only the live ones are held.
+ * The shown forms can then be bound to input values in O(inputs) each, however long the chains behind them.
+ */
+class LinearEvaluator {
+public:
+    /**
+     * Initializes the evaluator with a reference to an IR program.
+     *
+     * @param ir - the program to evaluate
+     */
+    explicit LinearEvaluator(const IRProgram& ir);
+
+    /**
+     * Computes the form of the value printed by each show statement.
+     *
+     * @return one form per show, in program order
+     */
+    [[nodiscard]] std::vector<LinearForm> evaluate() const;
+
+private:
+    const IRProgram& ir;  // Reference to the program to be evaluated
+};
+
+#endif // LINEAR_EVALUATOR_H
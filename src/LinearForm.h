@@ -0,0 +1,141 @@
+#ifndef LINEAR_FORM_H
+#define LINEAR_FORM_H
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Value.h"
+
+/**
+ * Struct naming a script input for analysis, and optionally the value it is bound to.
+ */
+struct InputBinding {
+    std::string name;            // Variable read by the script before any assignment
+    std::optional<Value> value;  // Value of the input, or empty to keep it symbolic
+};
+
+/**
+ * Struct representing a value as a linear combination of the script's inputs, constant + sum(coefficient * input).
+ * Terms are sorted by input slot and never have a zero coefficient, so equal forms have equal terms. Arithmetic
+ * wraps like every other LiteScript value, which keeps the form exact: evaluating it gives what the script prints.
+ */
+struct LinearForm {
+    Value constant = 0;                                  // Constant part
+    std::vector<std::pair<std::uint32_t, Value>> terms;  // Input slot and its coefficient
+
+    /**
+     * Returns the sum or difference of two forms, merging their terms in one pass.
+     *
+     * @param left - the left operand
+     * @param right - the right operand
+     * @param subtract - whether to subtract right instead of adding it
+     * @return the combined form
+     */
+    static LinearForm combine(const LinearForm& left, const LinearForm& right, const bool subtract) {
+        LinearForm result;
+        result.constant = subtract ? wrappingSub(left.constant, right.constant)
+                                   : wrappingAdd(left.constant, right.constant);
+        result.terms.reserve(left.terms.size() + right.terms.size());
+
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < left.terms.size() || j < right.terms.size()) {
+            if (j == right.terms.size() || (i < left.terms.size() && left.terms[i].first < right.terms[j].first)) {
+                result.terms.push_back(left.terms[i++]);
+                continue;
+            }
+            const Value coefficient = subtract ? wrappingSub(0, right.terms[j].second) : right.terms[j].second;
+
+            if (i == left.terms.size() || right.terms[j].first < left.terms[i].first) {
+                result.terms.emplace_back(right.terms[j++].first, coefficient);
+                continue;
+            }
+            const Value sum = wrappingAdd(left.terms[i].second, coefficient);
+            if (sum != 0) {
+                result.terms.emplace_back(left.terms[i].first, sum);
+            }
+            ++i;
+            ++j;
+        }
+        return result;
+    }
+
+    /**
+     * Substitutes the bound inputs, in O(terms) however long the computation that produced the form was.
+     *
+     * @param values - the value of each slot, or empty for inputs that stay symbolic
+     * @return the form over the remaining inputs; only a constant when every input it uses is bound
+     */
+    [[nodiscard]] LinearForm bind(const std::vector<std::optional<Value>>& values) const {
+        LinearForm result;
+        result.constant = constant;
+
+        for (const auto& [slot, coefficient] : terms) {
+            if (slot < values.size() && values[slot]) {
+                const std::uint64_t product = static_cast<std::uint64_t>(coefficient)
+                                              * static_cast<std::uint64_t>(*values[slot]);
+                result.constant = wrappingAdd(result.constant, static_cast<Value>(product));
+            } else {
+                result.terms.emplace_back(slot, coefficient);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Prints the form as an expression, such as `2*a - b + 7`, or just the constant if it has no terms.
+     *
+     * @param out - stream receiving the text
+     * @param names - the name of each slot
+     */
+    void print(std::ostream& out, const std::vector<std::string>& names) const {
+        bool first = true;
+
+        for (const auto& [slot, coefficient] : terms) {
+            printTerm(out, coefficient, first);
+            const std::uint64_t magnitude = magnitudeOf(coefficient);
+            if (magnitude != 1) {
+                out << magnitude << '*';
+            }
+            out << names[slot];
+            first = false;
+        }
+        if (first) {
+            out << constant;
+        } else if (constant != 0) {
+            printTerm(out, constant, false);
+            out << magnitudeOf(constant);
+        }
+    }
+
+private:
+    /**
+     * Returns the absolute value of a coefficient, which is representable even for the most negative value.
+     *
+     * @param value - the coefficient
+     * @return its magnitude
+     */
+    static std::uint64_t magnitudeOf(const Value value) {
+        return value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+    }
+
+    /**
+     * Prints the sign joining a term to the ones before it.
+     *
+     * @param out - stream receiving the text
+     * @param value - the term's coefficient
+     * @param first - whether the term is the first one printed
+     */
+    static void printTerm(std::ostream& out, const Value value, const bool first) {
+        if (first) {
+            out << (value < 0 ? "-" : "");
+        } else {
+            out << (value < 0 ? " - " : " + ");
+        }
+    }
+};
+
+#endif // LINEAR_FORM_H
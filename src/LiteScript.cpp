@@ -1,48 +1,323 @@
-#include "Litescript.h"
-#include <fstream>
-#include <stdexcept>
+#include "LiteScript.h"
+#include "SourceFile.h"
 #include "Lexer.h"
 #include "Parser.h"
+#include "Resolver.h"
+#include "Flattener.h"
+#include "IRBuilder.h"
+#include "IRVerifier.h"
+#include "IRPrinter.h"
+#include "IRLowerer.h"
+#include "LinearEvaluator.h"
+#include "Optimizer.h"
+#include "ShardedParser.h"
+#include "ThreadPool.h"
 #include "Compiler.h"
 #include "Interpreter.h"
+#include "ParallelInterpreter.h"
+#include "WorkStealingPool.h"
+#include "Jit.h"
+#include "BytecodeCompiler.h"
+#include "BytecodeFile.h"
+#include "VM.h"
+#include <sstream>
 
 /**
- * Loads a source file, tokenizes its contents, and parses it into an AST.
+ * Sets how the engines write shown values.
+ *
+ * @param options - when output is written
+ */
+void LiteScript::setOutputOptions(const OutputOptions options) {
+    outputOptions = options;
+}
+
+/**
+ * Declares the inputs of the next loaded script.
+ *
+ * @param inputs - the inputs, each optionally bound to a value
+ */
+void LiteScript::setInputs(std::vector<InputBinding> inputs) {
+    this->inputs = std::move(inputs);
+}
+
+/**
+ * Sets the stream parse errors are reported to while loading.
+ *
+ * @param out - the stream
+ */
+void LiteScript::setDiagnostics(std::ostream& out) {
+    diagnostics = &out;
+}
+
+/**
+ * Loads a source file. The file is mapped rather than copied, and tokens point into the mapping until parsing
+ * is done.
  *
  * @param filename - the name of the source file to load
+ * @param threads - the number of threads to lex and parse on
+ * @param optLevel - the optimization level of the IR pass pipeline
  */
-void LiteScript::loadFile(const std::string& filename) {
-    std::ifstream file(filename);
+void LiteScript::loadFile(const std::string& filename, const unsigned threads, const int optLevel) {
+    // Map the file contents; the AST copies out every name it keeps, so the mapping can go after parsing
+    const SourceFile source(filename);
+    loadSource(source.view(), threads, optLevel);
+}
 
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file: " + filename);
+/**
+ * Tokenizes a script, parses it into an AST, resolves its variables to slots, translates it to SSA form,
+ * optimizes it, and lowers it to a flat program. The AST itself is only kept until the IR has been built.
+ *
+ * With more than one thread, lexing and parsing are split across a thread pool by ShardedParser;
+ * resolution and lowering stay sequential, since slots are numbered in program order.
+ *
+ * @param source - the script's source text
+ * @param threads - the number of threads to lex and parse on
+ * @param optLevel - the optimization level of the IR pass pipeline
+ */
+void LiteScript::loadSource(const std::string_view source, const unsigned threads, const int optLevel) {
+    if (threads > 1) {
+        ThreadPool pool(threads);
+        ShardedParser parser(source, pool, *diagnostics);  // Owns the shards' arenas, so it lives until lowering is done
+        std::vector<ASTNode*> ast;
+        parser.parse(&ast);
+        lower(ast, optLevel);
+        return;
     }
-    // Read the entire file contents into a string
-    const std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
     // Lexical analysis: tokenize the source code
     Lexer lexer(source);
     const std::vector<Token> tokens = lexer.tokenize();
 
-    // Parse the tokens into an Abstract Syntax Tree (AST)
-    Parser parser(tokens);
+    // Parse the tokens into an Abstract Syntax Tree (AST) owned by the arena
+    Arena arena;
+    std::vector<ASTNode*> ast;
+    Parser parser(tokens, arena, *diagnostics);
     parser.parse(&ast);
+    lower(ast, optLevel);
+}
+
+/**
+ * Resolves a parsed AST, translates it to SSA form and optimizes it there, then lowers the IR into the flat
+ * program. The IR is verified once built and again after every optimization pass.
+ *
+ * @param ast - the parsed statements
+ * @param optLevel - the optimization level
+ */
+void LiteScript::lower(const std::vector<ASTNode*>& ast, const int optLevel) {
+    // Bind variables to slots, rejecting undefined reads before anything runs
+    FlatProgram resolved;
+    Resolver resolver(resolved.slotNames);
+    for (const InputBinding& input : inputs) {
+        resolver.declareInput(input.name);
+    }
+    resolver.resolve(ast);
+
+    // Flatten the AST, then rename its variables into SSA values
+    Flattener flattener(resolved);
+    flattener.flatten(ast);
+    IRBuilder builder(ir);
+    builder.build(resolved);
+    IRVerifier(ir).verify();
+
+    Optimizer optimizer(ir);
+    optimizer.optimize(optLevel);
+    numbering = optimizer.valueNumberingReport();
+
+    // Lower the IR into the flat representation shared by every backend
+    IRLowerer lowerer(ir, program);
+    lowerer.lower();
+}
+
+/**
+ * Evaluates the loaded program symbolically, then binds the inputs that have values in each shown form.
+ *
+ * @param out - stream receiving one "Result: " line per show statement
+ */
+void LiteScript::analyze(std::ostream& out) const {
+    // Inputs are declared first, so their slots are the ones they were declared in
+    std::vector<std::optional<Value>> values(ir.slotNames.size());
+    for (std::size_t i = 0; i < inputs.size() && i < values.size(); ++i) {
+        values[i] = inputs[i].value;
+    }
+
+    LinearEvaluator evaluator(ir);
+    for (const LinearForm& form : evaluator.evaluate()) {
+        out << "Result: ";
+        form.bind(values).print(out, ir.slotNames);
+        out << '\n';
+    }
+    out.flush();
+}
+
+/**
+ * Prints the loaded program's IR, after optimization.
+ *
+ * @param out - stream receiving the text
+ */
+void LiteScript::dumpIR(std::ostream& out) const {
+    IRPrinter printer(ir);
+    printer.print(out);
 }
 
 /**
- * Interprets the loaded AST by executing each node in sequence.
+ * Runs a source file one statement at a time: each statement is lexed, parsed, resolved and lowered
+ * only when the previous one has executed, then dropped. Memory use is bounded by the largest statement
+ * and the number of distinct variables, not by the length of the script. Output is buffered like every other
+ * engine's; with --flush-every=1 each value is written as soon as it is shown.
+ *
+ * @param filename - the name of the source file to run
  */
-void LiteScript::interpret() const {
-    Interpreter interpreter(ast);
-    interpreter.execute();
+void LiteScript::streamFile(const std::string& filename) {
+    const SourceFile source(filename);
+    Lexer lexer(source.view());
+    Arena arena;
+    Parser parser(lexer, arena, *diagnostics);
+
+    FlatProgram statement;  // Holds only the statement being executed, plus the slot table
+    Resolver resolver(statement.slotNames);
+    Flattener flattener(statement);
+    OutputBuffer output(OutputBuffer::STANDARD_OUTPUT, outputOptions);
+    Interpreter interpreter(statement, output);
+
+    while (!parser.isAtEnd()) {
+        arena.reset();  // Drop the previous statement's AST
+        ASTNode* node = parser.parseStatement();
+
+        if (!node) continue;  // Errors were reported by the parser
+
+        resolver.resolveStatement(*node);
+        statement.clearCode();
+        flattener.flattenStatement(*node);
+        interpreter.execute();
+    }
+    output.flush();  // Report a failed write
 }
 
 /**
- * Compiles the loaded AST into an assembly file.
+ * Interprets the loaded program with the selected engine.
+ * The tree engine evaluates the flat program node by node; the VM engine first lowers it to bytecode; the JIT
+ * engine runs it as native code where the host supports it, and otherwise uses the tree engine.
+ * With more than one thread, the tree engine sums very large expressions on a thread pool. The parallel engine
+ * runs statements that do not depend on each other concurrently, on a work-stealing pool. Every engine writes
+ * to one OutputBuffer on standard output.
  *
- * @param filename - the name of the output assembly file
+ * @param engine - the engine to run the script on
+ * @param threads - the number of threads the tree or parallel engine may use
  */
-void LiteScript::compile(const std::string& filename) const {
-    Compiler compiler(ast);
-    compiler.compile(filename);
+void LiteScript::interpret(const Engine engine, const unsigned threads) const {
+    OutputBuffer output(OutputBuffer::STANDARD_OUTPUT, outputOptions);
+
+    if (engine == Engine::JIT && Jit::isSupported()) {
+        Jit jit(program, output);
+        jit.execute();
+    } else if (engine == Engine::PARALLEL) {
+        WorkStealingPool pool(threads > 1 ? threads : 0);  // Declared first, so it outlives the interpreter's tasks
+        ParallelInterpreter interpreter(program, pool, output);
+        interpreter.execute();
+    } else if (engine == Engine::VM) {
+        const Chunk chunk = bytecode();
+        VM vm(chunk.view(), output);
+        vm.execute();
+    } else if (threads > 1) {
+        ThreadPool pool(threads);
+        Interpreter interpreter(program, output, &pool);
+        interpreter.execute();
+    } else {
+        Interpreter interpreter(program, output);
+        interpreter.execute();
+    }
+    output.flush();  // Report a failed write
+}
+
+/**
+ * Lowers the loaded program to the bytecode the VM engine runs, and writes it with its constant pool and slot
+ * table as a bytecode file.
+ *
+ * @param filename - the name of the bytecode file to write
+ */
+void LiteScript::build(const std::string& filename) const {
+    BytecodeFile::write(bytecode(), filename);
+}
+
+/**
+ * Lowers the loaded program to bytecode; each flat node becomes one stack instruction.
+ *
+ * @return the compiled chunk
+ */
+Chunk LiteScript::bytecode() const {
+    BytecodeCompiler bytecodeCompiler(program);
+    return bytecodeCompiler.compile();
+}
+
+/**
+ * Maps a bytecode file and runs it on the VM. The program was optimized when it was built; nothing is lexed,
+ * parsed or lowered here.
+ *
+ * @param filename - the name of the .lsc file
+ */
+void LiteScript::interpretBytecodeFile(const std::string& filename) const {
+    const BytecodeFile file(filename);
+    OutputBuffer output(OutputBuffer::STANDARD_OUTPUT, outputOptions);
+    VM vm(file.chunk(), output);
+    vm.execute();
+    output.flush();  // Report a failed write
+}
+
+/**
+ * Compiles the loaded program into a native executable and runs it.
+ *
+ * @param filename - the name of the output executable
+ * @param emitAsm - whether to also write the program's assembly to filename + ".asm"
+ */
+void LiteScript::compile(const std::string& filename, const bool emitAsm) const {
+    Compiler compiler(program);
+    compiler.compile(filename, emitAsm);
+}
+
+/**
+ * Compiles a source file through the build cache. The key covers the source text and the optimization level,
+ * the only option that changes the generated code; on a hit the stored executable is copied out and run
+ * without lexing, parsing or code generation. On a miss the file is loaded and compiled as usual, and the new
+ * executable is stored before it runs, unless loading reported parse errors: a hit would skip them, so a script
+ * with errors is compiled, and its errors printed, every time.
+ *
+ * @param filename - the name of the source file to compile
+ * @param executable - the name of the output executable
+ * @param threads - the number of threads to lex and parse on when the file has to be loaded
+ * @param optLevel - the optimization level
+ * @param emitAsm - whether to also write the program's assembly to executable + ".asm"
+ * @param cache - the build cache to consult and fill, or nullptr to always compile
+ */
+void LiteScript::compileFile(const std::string& filename, const std::string& executable, const unsigned threads,
+                             const int optLevel, const bool emitAsm, const BuildCache* cache) {
+    std::string key;
+
+    if (cache != nullptr) {
+        const SourceFile source(filename);
+        key = BuildCache::key(source.view(), "opt-level=" + std::to_string(optLevel));
+        if (cache->fetch(key, executable, emitAsm)) {
+            Compiler::run(executable);
+            return;
+        }
+    }
+
+    // Collect the parse errors while loading, to know whether any were reported, then pass them on
+    std::ostringstream loadDiagnostics;
+    std::ostream* const out = diagnostics;
+    diagnostics = &loadDiagnostics;
+    try {
+        loadFile(filename, threads, optLevel);
+    } catch (...) {
+        diagnostics = out;
+        *out << loadDiagnostics.str();
+        throw;
+    }
+    diagnostics = out;
+    *out << loadDiagnostics.str();
+
+    Compiler compiler(program);
+    compiler.build(executable, emitAsm);
+    if (cache != nullptr && loadDiagnostics.tellp() == 0) {
+        cache->store(key, executable, emitAsm);
+    }
+    Compiler::run(executable);
 }
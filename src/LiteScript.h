@@ -1,37 +1,161 @@
 #ifndef LITESCRIPT_H
 #define LITESCRIPT_H
 
-#include <vector>
+#include <iostream>
+#include <ostream>
+#include <string_view>
 #include <string>
-#include <memory>
+#include <vector>
 #include "AST.h"
+#include "Bytecode.h"
+#include "BuildCache.h"
+#include "FlatProgram.h"
+#include "IR.h"
+#include "LinearForm.h"
+#include "OutputBuffer.h"
+#include "Optimizer.h"
+
+/**
+ * Enum class selecting the engine used to interpret a loaded script.
+ */
+enum class Engine {
+    TREE,      // Evaluate the flat program directly with the Interpreter
+    VM,        // Compile the flat program to bytecode and run it on the VM
+    JIT,       // Compile the flat program to machine code in memory and call it, falling back to TREE off x86-64
+    PARALLEL   // Run independent runs of statements concurrently on a work-stealing pool
+};
 
 /**
  * LiteScript class is responsible for managing the overall workflow:
- * loading a source file, parsing it into an AST, interpreting the AST,
- * and compiling it to an assembly file if needed.
+ * loading a source file, parsing it into an AST, lowering it to a flat program,
+ * interpreting that program, and compiling it to a native executable if needed.
  */
 class LiteScript {
 public:
     /**
-     * Loads a source file, tokenizes and parses it, and generates an AST.
+     * Sets how the engines write shown values: written in large blocks by default, or flushed every N values,
+     * optionally from a background thread.
+     * @param options - when output is written
+     */
+    void setOutputOptions(OutputOptions options);
+
+    /**
+     * Declares the inputs of the next loaded script: variables it may read before assigning them.
+     * Only the analyze action gives them meaning; the engines and the compiler do not read inputs.
+     * @param inputs - the inputs, each optionally bound to a value
+     */
+    void setInputs(std::vector<InputBinding> inputs);
+
+    /**
+     * Loads a source file, tokenizes and parses it, optimizes the resolved program in SSA form, and lowers it to
+     * a flat program; every engine and the compiler then run the optimized program.
      * @param filename - the name of the source file to load
+     * @param threads - the number of threads to lex and parse on; 1 keeps the front-end sequential
+     * @param optLevel - the optimization level, from 0 (none) to Optimizer::MAX_LEVEL
      */
-    void loadFile(const std::string& filename);
+    void loadFile(const std::string& filename, unsigned threads = 1, int optLevel = Optimizer::MAX_LEVEL);
 
     /**
-     * Interprets the loaded AST by executing each node sequentially.
+     * Loads a script from its text, exactly as loadFile loads a file.
+     * @param source - the script's source text, which need only stay valid during the call
+     * @param threads - the number of threads to lex and parse on; 1 keeps the front-end sequential
+     * @param optLevel - the optimization level, from 0 (none) to Optimizer::MAX_LEVEL
      */
-    void interpret() const;
+    void loadSource(std::string_view source, unsigned threads = 1, int optLevel = Optimizer::MAX_LEVEL);
 
     /**
-     * Compiles the loaded AST into an assembly file.
-     * @param filename - the name of the output assembly file
+     * Sets the stream parse errors are reported to while loading; std::cerr by default.
+     * @param out - the stream, which must outlive every later load
      */
-    void compile(const std::string& filename) const;
+    void setDiagnostics(std::ostream& out);
+
+    /**
+     * Compiles the loaded program to the bytecode the VM engine runs.
+     * @return the compiled chunk
+     */
+    [[nodiscard]] Chunk bytecode() const;
+
+    /**
+     * Evaluates the loaded program symbolically and prints, for each show statement, its value as a linear form
+     * over the unbound inputs; with every input bound, or none declared, this is the value the script prints.
+     * @param out - stream receiving one "Result: " line per show statement
+     */
+    void analyze(std::ostream& out) const;
+
+    /**
+     * Prints the loaded program's SSA intermediate representation, as optimized.
+     * @param out - stream receiving the text
+     */
+    void dumpIR(std::ostream& out) const;
+
+    /**
+     * Returns what value numbering removed while the program was loaded.
+     * @return the value numbering report; all zero below optimization level 1
+     */
+    [[nodiscard]] const ValueNumberingReport& valueNumberingReport() const { return numbering; }
+
+    /**
+     * Interprets a source file as a stream, executing each statement as soon as it is parsed.
+     * Nothing is kept between statements except variable values, so memory does not grow with the script.
+     * @param filename - the name of the source file to run
+     */
+    void streamFile(const std::string& filename);
+
+    /**
+     * Interprets the loaded program with the selected engine.
+     * @param engine - the engine to run the script on
+     * @param threads - the number of threads the tree engine may sum large expressions on, or the parallel engine
+     *                  runs statements on; the parallel engine uses every hardware thread when this is 1
+     */
+    void interpret(Engine engine = Engine::TREE, unsigned threads = 1) const;
+
+    /**
+     * Compiles the loaded program to bytecode and writes it as a .lsc file, which interpretBytecodeFile runs
+     * without loading the source again.
+     * @param filename - the name of the bytecode file to write
+     */
+    void build(const std::string& filename) const;
+
+    /**
+     * Runs a bytecode file written by build on the VM engine, straight from its mapping.
+     * @param filename - the name of the .lsc file
+     */
+    void interpretBytecodeFile(const std::string& filename) const;
+
+    /**
+     * Compiles the loaded program into a native executable and runs it.
+     * @param filename - the name of the output executable
+     * @param emitAsm - whether to also write the program's assembly to filename + ".asm"
+     */
+    void compile(const std::string& filename, bool emitAsm = false) const;
+
+    /**
+     * Compiles a source file into a native executable and runs it, reusing the executable stored in a build
+     * cache for the same source, compiler version and options instead of loading the file at all.
+     * @param filename - the name of the source file to compile
+     * @param executable - the name of the output executable
+     * @param threads - the number of threads to lex and parse on when the file has to be loaded
+     * @param optLevel - the optimization level
+     * @param emitAsm - whether to also write the program's assembly to executable + ".asm"
+     * @param cache - the build cache to consult and fill, or nullptr to always compile
+     */
+    void compileFile(const std::string& filename, const std::string& executable, unsigned threads, int optLevel,
+                     bool emitAsm, const BuildCache* cache);
 
 private:
-    std::vector<std::unique_ptr<ASTNode>> ast;  // Abstract Syntax Tree generated from source file
+    /**
+     * Resolves a parsed AST, optimizes it as IR, and lowers the IR into the flat program.
+     * @param ast - the parsed statements
+     * @param optLevel - the optimization level
+     */
+    void lower(const std::vector<ASTNode*>& ast, int optLevel);
+
+    std::vector<InputBinding> inputs;  // Inputs declared for the script, with their bound values
+    OutputOptions outputOptions;       // When the engines write shown values
+    std::ostream* diagnostics = &std::cerr;  // Stream that parse errors are reported to
+    IRProgram ir;                      // SSA form of the program, kept for --emit-ir and analysis
+    ValueNumberingReport numbering;    // What value numbering removed, kept for --opt-report
+    FlatProgram program;               // Flat program generated from source file
 };
 
 #endif // LITESCRIPT_H
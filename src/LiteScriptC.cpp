@@ -0,0 +1,109 @@
+#include "LiteScriptC.h"
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include "ScriptProgram.h"
+
+/**
+ * Struct behind the opaque C handle: a copy of the C++ program handle.
+ */
+struct litescript_program {
+    ScriptProgram program;  // The compiled script
+};
+
+namespace {
+
+/**
+ * CallbackSink class forwards shown values to a C callback.
+ */
+class CallbackSink final : public OutputSink {
+public:
+    // Constructor initializes the sink with the callback and its context
+    CallbackSink(const litescript_sink sink, void* context) : sink(sink), context(context) {}
+
+    /**
+     * Passes the value to the callback.
+     *
+     * @param value - the value shown
+     */
+    void writeResult(const Value value) override { sink(context, value); }
+
+private:
+    litescript_sink sink;  // Callback receiving the values
+    void* context;         // Caller's context, passed back unchanged
+};
+
+/**
+ * Copies a message into memory the caller frees with litescript_free_error.
+ *
+ * @param message - the message
+ * @param error - where to store the copy, or NULL to drop it
+ */
+void reportError(const char* message, char** error) {
+    if (error == nullptr) {
+        return;
+    }
+    const std::size_t size = std::strlen(message) + 1;
+    *error = static_cast<char*>(std::malloc(size));
+    if (*error != nullptr) {
+        std::memcpy(*error, message, size);
+    }
+}
+
+/**
+ * Runs a compile, turning its result into a new handle and any exception into an error message.
+ *
+ * @param compile - produces the ScriptProgram
+ * @param error - where to store the message on failure, or NULL
+ * @return the handle, or NULL on failure
+ */
+template <typename Compile>
+litescript_program* makeProgram(Compile compile, char** error) {
+    if (error != nullptr) {
+        *error = nullptr;
+    }
+    try {
+        return new litescript_program{compile()};
+    } catch (const std::exception& exception) {
+        reportError(exception.what(), error);
+    } catch (...) {
+        reportError("Unknown error", error);
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+litescript_program* litescript_compile(const char* source, const size_t length, char** error) {
+    return makeProgram([source, length] { return ScriptProgram::compile(std::string_view(source, length)); },
+                       error);
+}
+
+litescript_program* litescript_compile_file(const char* filename, char** error) {
+    return makeProgram([filename] { return ScriptProgram::compileFile(filename); }, error);
+}
+
+int litescript_run(const litescript_program* program, const litescript_sink sink, void* context, char** error) {
+    if (error != nullptr) {
+        *error = nullptr;
+    }
+    CallbackSink output(sink, context);
+    try {
+        program->program.run(output);
+    } catch (const std::exception& exception) {
+        reportError(exception.what(), error);
+        return -1;
+    } catch (...) {
+        reportError("Unknown error", error);
+        return -1;
+    }
+    return 0;
+}
+
+void litescript_release(litescript_program* program) {
+    delete program;
+}
+
+void litescript_free_error(char* error) {
+    std::free(error);
+}
@@ -0,0 +1,74 @@
+#ifndef LITESCRIPT_C_H
+#define LITESCRIPT_C_H
+
+/*
+ * C interface to the LiteScript embedding API, for hosts written in C or in languages that call C.
+ *
+ * A program is compiled once into an immutable handle and can then be run any number of times, from any number
+ * of threads at once: every run has its own variables and reports each shown value to a callback the caller
+ * passes in. No function here lets an exception escape.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Opaque handle to a compiled script */
+typedef struct litescript_program litescript_program;
+
+/* Receives the value of each show statement, in order, with the context passed to litescript_run */
+typedef void (*litescript_sink)(void* context, int64_t value);
+
+/**
+ * Compiles a script from its text, at the highest optimization level.
+ *
+ * @param source - the script's source text, which need not be null-terminated
+ * @param length - the number of bytes of source
+ * @param error - if not NULL, receives a message to free with litescript_free_error when compiling fails
+ * @return the program, or NULL if the script does not compile cleanly
+ */
+litescript_program* litescript_compile(const char* source, size_t length, char** error);
+
+/**
+ * Compiles a script from a source file, exactly as litescript_compile does from text.
+ *
+ * @param filename - the name of the source file
+ * @param error - if not NULL, receives a message to free with litescript_free_error when compiling fails
+ * @return the program, or NULL if the file cannot be read or does not compile cleanly
+ */
+litescript_program* litescript_compile_file(const char* filename, char** error);
+
+/**
+ * Runs a program from the start with all of its variables fresh. Safe to call concurrently on one program.
+ *
+ * @param program - the program to run
+ * @param sink - the callback receiving shown values; a C++ callback may throw to stop the run
+ * @param context - passed unchanged to every call of sink
+ * @param error - if not NULL, receives a message to free with litescript_free_error when the run fails
+ * @return 0 once the program has run to the end; -1 if it was stopped by an exception from sink, or could not
+ *         start because its variables could not be allocated. Values passed to sink before the failure stand.
+ */
+int litescript_run(const litescript_program* program, litescript_sink sink, void* context, char** error);
+
+/**
+ * Releases a program. It must not be running, or be run again, once released.
+ *
+ * @param program - the program to release, or NULL
+ */
+void litescript_release(litescript_program* program);
+
+/**
+ * Frees a message returned by a failed compile or run.
+ *
+ * @param error - the message, or NULL
+ */
+void litescript_free_error(char* error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LITESCRIPT_C_H */
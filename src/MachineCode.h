@@ -0,0 +1,105 @@
+#ifndef MACHINE_CODE_H
+#define MACHINE_CODE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Enum class naming the x86-64 general-purpose registers, numbered as in their machine encoding.
+ */
+enum class Register : std::uint8_t {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+/**
+ * Enum class representing the x86-64 instructions the Compiler generates.
+ */
+enum class Mnemonic : std::uint8_t {
+    MOV,      // Copy source into destination
+    ADD,      // Add source to destination
+    SUB,      // Subtract source from destination
+    XOR,      // Exclusive-or source into destination
+    TEST,     // Set flags from destination AND source
+    LEA,      // Load the address of a memory source into a register
+    NEG,      // Negate destination
+    DEC,      // Decrement destination
+    DIV,      // Unsigned divide rdx:rax by destination
+    MUL,      // Unsigned multiply rax by destination into rdx:rax
+    SHR,      // Shift destination right by a constant, filling with zeros
+    PUSH,     // Push a register
+    POP,      // Pop into a register
+    CALL,     // Call a code label, or the address in a register
+    JNS,      // Jump to a code label if the sign flag is clear
+    JNZ,      // Jump to a code label if the zero flag is clear
+    JZ,       // Jump to a code label if the zero flag is set
+    JMP,      // Jump to a code label
+    RET,      // Return from a call
+    SYSCALL,  // Enter the kernel
+    LABEL     // Pseudo-instruction defining a code label at this point
+};
+
+/**
+ * Struct representing one operand of a machine instruction.
+ */
+struct Operand {
+    /**
+     * Enum representing what an operand refers to.
+     */
+    enum Kind : std::uint8_t {
+        NONE,       // No operand
+        REGISTER,   // A register
+        IMMEDIATE,  // A constant
+        MEMORY,     // [base + displacement]
+        SYMBOL,     // A data symbol, addressed relative to the instruction pointer
+        LABEL       // A code label
+    };
+
+    Kind kind = NONE;
+    Register reg = Register::RAX;    // The register, or the base of a MEMORY operand
+    std::int32_t displacement = 0;   // Displacement of a MEMORY operand
+    std::int64_t immediate = 0;      // Value of an IMMEDIATE operand
+    std::uint32_t index = 0;         // Symbol index of a SYMBOL operand, label index of a LABEL operand
+
+    static Operand ofRegister(const Register reg) { return {REGISTER, reg, 0, 0, 0}; }
+    static Operand ofImmediate(const std::int64_t value) { return {IMMEDIATE, Register::RAX, 0, value, 0}; }
+    static Operand ofMemory(const Register base, const std::int32_t displacement = 0) {
+        return {MEMORY, base, displacement, 0, 0};
+    }
+    static Operand ofSymbol(const std::uint32_t symbol) { return {SYMBOL, Register::RAX, 0, 0, symbol}; }
+    static Operand ofLabel(const std::uint32_t label) { return {LABEL, Register::RAX, 0, 0, label}; }
+};
+
+/**
+ * Struct representing a single machine instruction. The width, in bits (8, 32 or 64), applies to register
+ * names and memory accesses.
+ */
+struct MachineInstruction {
+    Mnemonic mnemonic;
+    std::uint8_t width;
+    Operand destination;
+    Operand source;
+};
+
+/**
+ * Struct representing a data symbol: initialized read-only bytes, or zeroed storage when it has no initializer.
+ */
+struct DataSymbol {
+    std::string name;          // Assembly label
+    std::string initializer;   // Initial bytes; empty for zeroed storage
+    std::uint32_t size;        // Size in bytes
+};
+
+/**
+ * Struct representing a generated program as a list of machine instructions plus the labels and data they use.
+ * It is printed as NASM text by the AsmPrinter and encoded to bytes by the X86Encoder.
+ */
+struct MachineProgram {
+    std::vector<MachineInstruction> code;   // Instructions in program order
+    std::vector<std::string> labels;        // Name of each code label
+    std::vector<DataSymbol> symbols;        // Data referenced by SYMBOL operands
+    std::uint32_t entry = 0;                // Label where execution starts
+};
+
+#endif // MACHINE_CODE_H
@@ -0,0 +1,195 @@
+#include "Optimizer.h"
+#include "IRVerifier.h"
+
+namespace {
+    /**
+     * Hashes an expression by its operation, operands and immediate, finalizing like SplitMix64 so that keys
+     * differing only in low bits spread over the whole table.
+     */
+    std::uint64_t hashExpression(const IROpcode opcode, const std::uint32_t lhs, const std::uint32_t rhs,
+                                 const Value immediate) {
+        std::uint64_t hash = static_cast<std::uint64_t>(immediate);
+        hash ^= (static_cast<std::uint64_t>(lhs) << 32 | rhs) + 0x9E3779B97F4A7C15ull + (hash << 6);
+        hash ^= static_cast<std::uint64_t>(opcode) << 56;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        return hash ^ (hash >> 31);
+    }
+}
+
+// Constructor initializes the optimizer with the program to rewrite
+Optimizer::Optimizer(IRProgram& ir) : ir(ir) {}
+
+/**
+ * Runs the pass pipeline for an optimization level, verifying the IR after every pass.
+ *
+ * @param level - the optimization level
+ */
+void Optimizer::optimize(const int level) {
+    report = ValueNumberingReport();
+
+    if (level >= 1) {
+        report.instructions = ir.size();
+        for (const IROpcode opcode : ir.opcodes) {
+            if (opcode == IROpcode::ADD || opcode == IROpcode::SUB) {
+                ++report.arithmetic;
+            }
+        }
+        numberValues();
+        IRVerifier(ir).verify();
+        foldConstants();
+        IRVerifier(ir).verify();
+        // Folding produces new constants, and new operations over them, that may equal earlier values
+        numberValues();
+        IRVerifier(ir).verify();
+    }
+    if (level >= 2) {
+        eliminateDeadCode();
+        IRVerifier(ir).verify();
+    }
+}
+
+/**
+ * Rebuilds the program in one forward pass. Operands are renamed to their replacements first, so an expression
+ * over values that were themselves duplicates is recognized too; a `let` of a reused value keeps no binding of
+ * its own, exactly like a copy.
+ */
+void Optimizer::numberValues() {
+    IRProgram output;
+    std::vector<std::uint32_t> replacement(ir.size(), IRProgram::NONE);
+    output.slotNames = std::move(ir.slotNames);
+
+    // Open-addressing table of output values, at most half full; keys are compared against the output itself
+    std::size_t capacity = 16;
+    while (capacity < 2 * static_cast<std::size_t>(ir.size())) {
+        capacity *= 2;
+    }
+    std::vector<std::uint32_t> table(capacity, IRProgram::NONE);
+
+    for (std::uint32_t value = 0; value < ir.size(); ++value) {
+        const IROpcode opcode = ir.opcodes[value];
+        std::uint32_t lhs = ir.lhs[value] == IRProgram::NONE ? IRProgram::NONE : replacement[ir.lhs[value]];
+        std::uint32_t rhs = ir.rhs[value] == IRProgram::NONE ? IRProgram::NONE : replacement[ir.rhs[value]];
+        const bool arithmetic = opcode == IROpcode::ADD || opcode == IROpcode::SUB;
+
+        if (opcode == IROpcode::SHOW) {
+            replacement[value] = output.append(opcode, lhs, rhs, 0, ir.slots[value]);
+            continue;
+        }
+        if (opcode == IROpcode::ADD && rhs < lhs) {
+            std::swap(lhs, rhs);
+        }
+
+        // An input is identified by its variable, which it reads before anything is assigned to it
+        const bool input = opcode == IROpcode::INPUT;
+        const Value immediate = input ? ir.slots[value] : ir.immediates[value];
+        std::size_t bucket = hashExpression(opcode, lhs, rhs, immediate) & (capacity - 1);
+
+        while (table[bucket] != IRProgram::NONE) {
+            const std::uint32_t candidate = table[bucket];
+            if (output.opcodes[candidate] == opcode && output.lhs[candidate] == lhs && output.rhs[candidate] == rhs
+                && (input ? output.slots[candidate] : output.immediates[candidate]) == immediate) {
+                break;
+            }
+            bucket = (bucket + 1) & (capacity - 1);
+        }
+
+        if (table[bucket] == IRProgram::NONE) {
+            table[bucket] = output.append(opcode, lhs, rhs, ir.immediates[value], ir.slots[value]);
+        } else {
+            ++report.removed;
+            if (arithmetic) {
+                ++report.arithmeticRemoved;
+            }
+        }
+        replacement[value] = table[bucket];
+    }
+
+    output.exits = std::move(ir.exits);
+    for (std::uint32_t& value : output.exits) {
+        if (value != IRProgram::NONE) {
+            value = replacement[value];
+        }
+    }
+    ir = std::move(output);
+}
+
+/**
+ * Rebuilds the program in one forward pass, mapping every original value to its folded replacement.
+ */
+void Optimizer::foldConstants() {
+    IRProgram output;
+    std::vector<std::uint32_t> replacement(ir.size(), IRProgram::NONE);
+    output.slotNames = std::move(ir.slotNames);
+
+    for (std::uint32_t value = 0; value < ir.size(); ++value) {
+        const IROpcode opcode = ir.opcodes[value];
+        const std::uint32_t slot = ir.slots[value];
+
+        if (opcode != IROpcode::ADD && opcode != IROpcode::SUB) {
+            const std::uint32_t operand = ir.lhs[value] == IRProgram::NONE ? IRProgram::NONE : replacement[ir.lhs[value]];
+            replacement[value] = output.append(opcode, operand, IRProgram::NONE, ir.immediates[value], slot);
+            continue;
+        }
+
+        const std::uint32_t lhs = replacement[ir.lhs[value]];
+        const std::uint32_t rhs = replacement[ir.rhs[value]];
+        const bool lhsConstant = output.opcodes[lhs] == IROpcode::CONST;
+        const bool rhsConstant = output.opcodes[rhs] == IROpcode::CONST;
+
+        if (lhsConstant && rhsConstant) {
+            const Value result = opcode == IROpcode::ADD ? wrappingAdd(output.immediates[lhs], output.immediates[rhs])
+                                                         : wrappingSub(output.immediates[lhs], output.immediates[rhs]);
+            replacement[value] = output.append(IROpcode::CONST, IRProgram::NONE, IRProgram::NONE, result, slot);
+        } else if (rhsConstant && output.immediates[rhs] == 0) {
+            replacement[value] = lhs;  // x + 0 and x - 0 are x
+        } else if (lhsConstant && output.immediates[lhs] == 0 && opcode == IROpcode::ADD) {
+            replacement[value] = rhs;  // 0 + x is x
+        } else {
+            replacement[value] = output.append(opcode, lhs, rhs, 0, slot);
+        }
+    }
+
+    output.exits = std::move(ir.exits);
+    for (std::uint32_t& value : output.exits) {
+        if (value != IRProgram::NONE) {
+            value = replacement[value];
+        }
+    }
+    ir = std::move(output);
+}
+
+/**
+ * Marks the values show statements depend on in one backward pass, then rebuilds the program from those values
+ * and the shows, renumbering operands.
+ */
+void Optimizer::eliminateDeadCode() {
+    std::vector<bool> live(ir.size(), false);
+
+    for (std::uint32_t value = ir.size(); value-- > 0;) {
+        if (ir.opcodes[value] == IROpcode::SHOW) {
+            live[value] = true;
+        }
+        if (live[value] && ir.lhs[value] != IRProgram::NONE) {
+            live[ir.lhs[value]] = true;
+        }
+        if (live[value] && ir.rhs[value] != IRProgram::NONE) {
+            live[ir.rhs[value]] = true;
+        }
+    }
+
+    IRProgram output;
+    std::vector<std::uint32_t> renumbered(ir.size(), IRProgram::NONE);
+    output.slotNames = std::move(ir.slotNames);
+    output.exits.assign(output.slotNames.size(), IRProgram::NONE);
+
+    for (std::uint32_t value = 0; value < ir.size(); ++value) {
+        if (!live[value]) {
+            continue;
+        }
+        const std::uint32_t lhs = ir.lhs[value] == IRProgram::NONE ? IRProgram::NONE : renumbered[ir.lhs[value]];
+        const std::uint32_t rhs = ir.rhs[value] == IRProgram::NONE ? IRProgram::NONE : renumbered[ir.rhs[value]];
+        renumbered[value] = output.append(ir.opcodes[value], lhs, rhs, ir.immediates[value], ir.slots[value]);
+    }
+    ir = std::move(output);
+}
@@ -0,0 +1,80 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+#include "IR.h"
+
+/**
+ * Struct recording what value numbering removed from a program.
+ */
+struct ValueNumberingReport {
+    std::uint32_t instructions = 0;       // Instructions before optimization
+    std::uint32_t removed = 0;            // Instructions replaced by an earlier identical value
+    std::uint32_t arithmetic = 0;         // Additions and subtractions before optimization
+    std::uint32_t arithmeticRemoved = 0;  // Additions and subtractions replaced by an earlier identical value
+};
+
+/**
+ * The Optimizer class rewrites an IRProgram before it is lowered for the backends, so the tree engine, the VM,
+ * the JIT and the compiler all run the optimized program.
+ *
+ * The optimization level selects the pass pipeline:
+ *   - 0: no optimization
+ *   - 1: value numbering, which reuses the earlier result of an identical expression over the same values, then
+ *        constant folding, then value numbering again to merge the constants folding produced; in SSA form this
+ *        also propagates constants and copies, since a use of a variable is a use of the value it was assigned
+ *   - 2: level 1, then dead-code elimination of every value that never reaches a show statement
+ *
+ * Each pass rebuilds the program and is followed by the IRVerifier. Values wrap on overflow exactly as at run
+ * time, so folding never changes what a script prints.
+ */
+class Optimizer {
+public:
+    static constexpr int MAX_LEVEL = 2;  // Highest level, running every pass
+
+    /**
+     * Initializes the optimizer with the program to rewrite in place.
+     *
+     * @param ir - the program to optimize
+     */
+    explicit Optimizer(IRProgram& ir);
+
+    /**
+     * Runs the passes selected by an optimization level.
+     *
+     * @param level - the optimization level, from 0 to MAX_LEVEL
+     */
+    void optimize(int level);
+
+    /**
+     * Returns what value numbering removed during the last optimize call; all zero if it did not run.
+     *
+     * @return the value numbering report
+     */
+    [[nodiscard]] const ValueNumberingReport& valueNumberingReport() const { return report; }
+
+private:
+    /**
+     * Replaces every constant, input and operation identical to an earlier one with that earlier value, adding
+     * what it removes to the report. Addition is commutative, so `a + b` and `b + a` share a value.
+     */
+    void numberValues();
+
+    /**
+     * Folds operations on constants into constants, and additions or subtractions of zero into their other
+     * operand. Later uses of a folded value use its replacement.
+     */
+    void foldConstants();
+
+    /**
+     * Removes every value that no show statement depends on, including assignments whose value is overwritten
+     * or never read. Final variable values are not kept at this level.
+     */
+    void eliminateDeadCode();
+
+    IRProgram& ir;               // Program being optimized
+    ValueNumberingReport report;  // What value numbering removed
+};
+
+#endif // OPTIMIZER_H
@@ -0,0 +1,199 @@
+#include "OutputBuffer.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    // "00" to "99", so values are formatted two digits per division
+    constexpr char DIGIT_PAIRS[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    constexpr char PREFIX[] = "Result: ";
+    constexpr std::size_t PREFIX_SIZE = sizeof(PREFIX) - 1;
+}
+
+// Constructor allocates the buffers and starts the writer thread if requested
+OutputBuffer::OutputBuffer(const int fd, const OutputOptions options) : fd(fd), options(options), buffer(CAPACITY) {
+    if (options.background) {
+        handedOff.resize(CAPACITY);
+        writer = std::thread(&OutputBuffer::writerLoop, this);
+    }
+}
+
+// Destructor writes what is left and joins the writer; errors can no longer be reported here
+OutputBuffer::~OutputBuffer() {
+    drain();
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        writer.join();
+    }
+}
+
+/**
+ * Appends "Result: N\n", draining the buffer first if the line might not fit, and flushes every
+ * options.flushEvery results.
+ *
+ * @param value - the value shown
+ */
+void OutputBuffer::writeResult(const Value value) noexcept {
+    if (CAPACITY - used < MAX_LINE) {
+        drain();
+    }
+    char digits[20];
+    char* const end = digits + sizeof(digits);
+    const char* const start = formatValue(value, end);
+    char* out = buffer.data() + used;
+
+    std::memcpy(out, PREFIX, PREFIX_SIZE);
+    out += PREFIX_SIZE;
+    std::memcpy(out, start, static_cast<std::size_t>(end - start));
+    out += end - start;
+    *out++ = '\n';
+    used = static_cast<std::size_t>(out - buffer.data());
+
+    if (options.flushEvery != 0 && ++sinceFlush >= options.flushEvery) {
+        sinceFlush = 0;
+        drain();
+        waitForWriter();
+    }
+}
+
+/**
+ * Drains the buffer, waits for the writer thread, and reports any write that failed.
+ */
+void OutputBuffer::flush() {
+    drain();
+    waitForWriter();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!failure.empty()) {
+        throw std::runtime_error(failure);
+    }
+}
+
+/**
+ * Formats a value in decimal from the end of the buffer backwards. The magnitude is taken as unsigned, so the
+ * most negative value needs no special case.
+ *
+ * @param value - the value to format
+ * @param end - one past the last character to write
+ * @return the first character written
+ */
+char* OutputBuffer::formatValue(const Value value, char* end) noexcept {
+    std::uint64_t magnitude = value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+
+    while (magnitude >= 100) {
+        const std::size_t pair = static_cast<std::size_t>(magnitude % 100) * 2;
+        magnitude /= 100;
+        *--end = DIGIT_PAIRS[pair + 1];
+        *--end = DIGIT_PAIRS[pair];
+    }
+    if (magnitude >= 10) {
+        const std::size_t pair = static_cast<std::size_t>(magnitude) * 2;
+        *--end = DIGIT_PAIRS[pair + 1];
+        *--end = DIGIT_PAIRS[pair];
+    } else {
+        *--end = static_cast<char>('0' + magnitude);
+    }
+    if (value < 0) {
+        *--end = '-';
+    }
+    return end;
+}
+
+/**
+ * Writes the buffer directly, or swaps it with the writer thread's once that one has been written.
+ */
+void OutputBuffer::drain() noexcept {
+    if (used == 0) {
+        return;
+    }
+    if (!writer.joinable()) {
+        writeAll(buffer.data(), used);
+        used = 0;
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return handedOffSize == 0; });
+        buffer.swap(handedOff);
+        handedOffSize = used;
+    }
+    changed.notify_all();
+    used = 0;
+}
+
+/**
+ * Blocks until the writer thread is idle; returns at once without one.
+ */
+void OutputBuffer::waitForWriter() noexcept {
+    if (writer.joinable()) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return handedOffSize == 0; });
+    }
+}
+
+/**
+ * Writes bytes with as many system calls as needed. After a failure nothing more is written, so the output
+ * never has a hole in the middle.
+ *
+ * @param data - the bytes to write
+ * @param size - the number of bytes
+ */
+void OutputBuffer::writeAll(const char* data, std::size_t size) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failure.empty()) {
+            return;
+        }
+    }
+    while (size > 0) {
+#ifdef _WIN32
+        const int written = _write(fd, data, static_cast<unsigned>(size));
+#else
+        const ssize_t written = write(fd, data, size);
+#endif
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            failure = std::string("Could not write output: ") + std::strerror(errno);
+            return;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+/**
+ * Waits for a handed-off buffer, writes it outside the lock, and marks the writer idle again.
+ */
+void OutputBuffer::writerLoop() noexcept {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for (;;) {
+        changed.wait(lock, [this] { return stopping || handedOffSize != 0; });
+        if (handedOffSize == 0) {
+            return;  // Stopping, and everything has been written
+        }
+        const std::size_t size = handedOffSize;
+        lock.unlock();
+        writeAll(handedOff.data(), size);
+        lock.lock();
+        handedOffSize = 0;
+        changed.notify_all();
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "OutputSink.h"
+#include "Value.h"
+
+/**
+ * Struct selecting when an OutputBuffer writes its contents.
+ */
+struct OutputOptions {
+    std::size_t flushEvery = 0;  // Flush after this many results; 0 writes only when the buffer fills and at the end
+    bool background = false;     // Write full buffers from a background thread while the script keeps running
+};
+
+/**
+ * OutputBuffer class collects the "Result: N" lines of show statements in a large user-space buffer and writes
+ * them to a file descriptor in big blocks, instead of one flushed write per line.
+ *
+ * Values are formatted by hand, two digits at a time, without iostreams. With a background writer, a full buffer
+ * is handed to a writer thread and the script continues in a second buffer, so output only stalls it when the
+ * writer falls a whole buffer behind.
+ *
+ * Writing a result never throws, so it can be called from JIT-compiled code; a failed write is remembered and
+ * reported by the next flush.
+ */
+class OutputBuffer final : public OutputSink {
+public:
+    static constexpr std::size_t CAPACITY = 1 << 16;  // Bytes buffered before a write
+    static constexpr std::size_t MAX_LINE = 32;       // Longest result line: "Result: " and 20 characters, newline
+    static constexpr int STANDARD_OUTPUT = 1;         // File descriptor of standard output
+
+    /**
+     * Initializes the buffer for a file descriptor.
+     *
+     * @param fd - the file descriptor to write to
+     * @param options - when to write
+     */
+    explicit OutputBuffer(int fd, OutputOptions options = {});
+
+    // Flushes what is left, ignoring errors, and stops the writer thread
+    ~OutputBuffer() override;
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    /**
+     * Appends the line printed by a show statement. Never throws, since the JIT calls it from generated code.
+     *
+     * @param value - the value shown
+     */
+    void writeResult(Value value) noexcept override;
+
+    /**
+     * Writes everything buffered and waits until it has been written.
+     * Throws if this or any earlier write failed.
+     */
+    void flush();
+
+    /**
+     * Formats a value in decimal, writing backwards from the end of a buffer of at least 20 characters.
+     *
+     * @param value - the value to format
+     * @param end - one past the last character to write
+     * @return the first character written
+     */
+    static char* formatValue(Value value, char* end) noexcept;
+
+private:
+    /**
+     * Writes the buffered bytes, or hands them to the writer thread, and starts a new buffer.
+     */
+    void drain() noexcept;
+
+    /**
+     * Waits until the writer thread has written everything handed to it.
+     */
+    void waitForWriter() noexcept;
+
+    /**
+     * Writes bytes to the file descriptor, retrying partial writes; records the first failure.
+     *
+     * @param data - the bytes to write
+     * @param size - the number of bytes
+     */
+    void writeAll(const char* data, std::size_t size) noexcept;
+
+    /**
+     * Writer thread loop: writes each handed-off buffer until the output is destroyed.
+     */
+    void writerLoop() noexcept;
+
+    int fd;                                // File descriptor receiving the output
+    OutputOptions options;                 // When to write
+    std::vector<char> buffer;              // Bytes being filled
+    std::size_t used = 0;                  // Bytes of buffer filled
+    std::size_t sinceFlush = 0;            // Results since the last flush
+    std::string failure;                   // Description of the first failed write; guarded by mutex with a writer
+    std::vector<char> handedOff;           // Bytes being written by the writer thread; guarded by mutex
+    std::size_t handedOffSize = 0;         // Bytes of handedOff to write, 0 when the writer is idle
+    bool stopping = false;                 // Set when the writer thread should exit; guarded by mutex
+    std::mutex mutex;                      // Guards the writer thread's state
+    std::condition_variable changed;       // Signalled when a buffer is handed off or written
+    std::thread writer;                    // Background writer, if enabled
+};
+
+#endif // OUTPUT_BUFFER_H
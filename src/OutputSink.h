@@ -0,0 +1,24 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include "Value.h"
+
+/**
+ * OutputSink class is the destination of the values a script shows. The engines report each shown value to a
+ * sink; an OutputBuffer formats them as "Result: N" lines for a file descriptor, and programs embedding
+ * LiteScript can receive the values directly.
+ */
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * Receives the value of a show statement. A sink may throw to stop the run; the exception reaches whoever
+     * started it.
+     *
+     * @param value - the value shown
+     */
+    virtual void writeResult(Value value) = 0;
+};
+
+#endif // OUTPUT_SINK_H
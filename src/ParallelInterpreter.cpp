@@ -0,0 +1,201 @@
+#include "ParallelInterpreter.h"
+#include <algorithm>
+
+// Constructor initializes the interpreter with the program, the pool to run it on, and its output
+ParallelInterpreter::ParallelInterpreter(const FlatProgram& program, WorkStealingPool& pool, OutputBuffer& output)
+    : program(program), pool(pool), output(output) {}
+
+/**
+ * Builds the dependency graph, queues the segments that depend on nothing, and prints each segment's values in
+ * program order as soon as it and every segment before it are done.
+ */
+void ParallelInterpreter::execute() {
+    slots.assign(program.slotNames.size(), 0);
+    createSegments();
+
+    // Each segment's accesses are independent of the others', so they are collected in parallel
+    forEachSegment([this](const std::uint32_t index) { collectAccesses(*segments[index]); });
+    linkSegments();
+
+    // Find the roots before queuing any, since a running segment releases its successors
+    std::vector<std::uint32_t> roots;
+    for (std::uint32_t index = 0; index < segments.size(); ++index) {
+        if (segments[index]->waiting == 0) {
+            roots.push_back(index);
+        }
+    }
+    for (const std::uint32_t index : roots) {
+        pool.submit([this, index] { runSegment(index); });
+    }
+
+    for (const std::unique_ptr<Segment>& segment : segments) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&segment] { return segment->done; });
+        }
+        for (const Value value : segment->printed) {
+            output.writeResult(value);
+        }
+    }
+}
+
+/**
+ * Cuts the statements into runs of at least SEGMENT_NODES nodes.
+ */
+void ParallelInterpreter::createSegments() {
+    segments.clear();
+    std::uint32_t nodes = SEGMENT_NODES;  // Nodes in the current segment; starts full so the first statement opens one
+
+    for (std::uint32_t statement = 0; statement < program.statements.size(); ++statement) {
+        if (nodes >= SEGMENT_NODES) {
+            segments.push_back(std::make_unique<Segment>());
+            segments.back()->firstStatement = statement;
+            nodes = 0;
+        }
+        segments.back()->endStatement = statement + 1;
+        nodes += program.statements[statement] + 1 - program.statementStart(statement);
+    }
+}
+
+/**
+ * Collects the slots read by identifiers and prints and written by assignments.
+ *
+ * @param segment - the segment
+ */
+void ParallelInterpreter::collectAccesses(Segment& segment) const {
+    const std::uint32_t first = program.statementStart(segment.firstStatement);
+    const std::uint32_t last = program.statements[segment.endStatement - 1];
+
+    for (std::uint32_t node = first; node <= last; ++node) {
+        const NodeType kind = program.kinds[node];
+
+        if (kind == IDENTIFIER || kind == PRINT) {
+            segment.reads.push_back(program.operands[node]);
+        } else if (kind == ASSIGN) {
+            segment.writes.push_back(program.operands[node]);
+        }
+    }
+    for (std::vector<std::uint32_t>* accesses : {&segment.reads, &segment.writes}) {
+        std::sort(accesses->begin(), accesses->end());
+        accesses->erase(std::unique(accesses->begin(), accesses->end()), accesses->end());
+    }
+}
+
+/**
+ * Links every segment to the last earlier segment writing each slot it touches, and, for each slot it writes,
+ * to the segments that read the slot since that write. Duplicate edges are skipped.
+ */
+void ParallelInterpreter::linkSegments() {
+    constexpr std::uint32_t NONE = UINT32_MAX;
+    std::vector<std::uint32_t> lastWriter(program.slotNames.size(), NONE);
+    std::vector<std::vector<std::uint32_t>> readers(program.slotNames.size());  // Readers since the last write
+    std::vector<std::uint32_t> linkedTo(segments.size(), NONE);                // Last segment each one was linked to
+
+    for (std::uint32_t index = 0; index < segments.size(); ++index) {
+        Segment& segment = *segments[index];
+        const auto link = [&](const std::uint32_t predecessor) {
+            if (predecessor != NONE && predecessor != index && linkedTo[predecessor] != index) {
+                linkedTo[predecessor] = index;
+                segments[predecessor]->successors.push_back(index);
+                ++segment.waiting;
+            }
+        };
+
+        for (const std::uint32_t slot : segment.reads) {
+            link(lastWriter[slot]);
+        }
+        for (const std::uint32_t slot : segment.writes) {
+            link(lastWriter[slot]);
+            for (const std::uint32_t reader : readers[slot]) {
+                link(reader);
+            }
+        }
+        for (const std::uint32_t slot : segment.writes) {
+            lastWriter[slot] = index;
+            readers[slot].clear();
+        }
+        for (const std::uint32_t slot : segment.reads) {
+            readers[slot].push_back(index);
+        }
+    }
+}
+
+/**
+ * Executes a segment's statements in order. Nodes are in post-order, so each node's operands have been
+ * evaluated when it is reached; the values of the current statement's nodes are kept in a local buffer.
+ * Successors are released before the segment is marked done, so that nothing touches the graph afterwards.
+ *
+ * @param index - the segment
+ */
+void ParallelInterpreter::runSegment(const std::uint32_t index) {
+    Segment& segment = *segments[index];
+    const NodeType* kinds = program.kinds.data();
+    const std::uint32_t* operands = program.operands.data();
+    const std::uint32_t* left = program.left.data();
+    const std::uint32_t* right = program.right.data();
+    std::vector<Value> values;
+
+    for (std::uint32_t statement = segment.firstStatement; statement < segment.endStatement; ++statement) {
+        const std::uint32_t start = program.statementStart(statement);
+        const std::uint32_t root = program.statements[statement];
+
+        values.resize(std::max<std::size_t>(values.size(), root - start + 1));
+        Value* local = values.data();  // Indexed by node index relative to start
+
+        for (std::uint32_t i = start; i <= root; ++i) {
+            switch (kinds[i]) {
+                case NUMBER:
+                    local[i - start] = program.constants[operands[i]];
+                    break;
+                case IDENTIFIER:
+                    local[i - start] = slots[operands[i]];
+                    break;
+                case BINARY_OP:
+                    local[i - start] = program.ops[i] == '+'
+                                           ? wrappingAdd(local[left[i] - start], local[right[i] - start])
+                                           : wrappingSub(local[left[i] - start], local[right[i] - start]);
+                    break;
+                case ASSIGN:
+                    slots[operands[i]] = local[left[i] - start];
+                    break;
+                case PRINT:
+                    segment.printed.push_back(slots[operands[i]]);
+                    break;
+            }
+        }
+    }
+
+    for (const std::uint32_t successor : segment.successors) {
+        if (segments[successor]->waiting.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pool.submit([this, successor] { runSegment(successor); });
+        }
+    }
+
+    // Last, and under the lock: once execute sees the final segment done, this object may be destroyed
+    std::lock_guard<std::mutex> lock(mutex);
+    segment.done = true;
+    finished.notify_all();
+}
+
+/**
+ * Runs a task for every segment on the pool and waits for all of them.
+ *
+ * @param task - the work to do for a segment index
+ */
+template <typename Task>
+void ParallelInterpreter::forEachSegment(Task task) {
+    std::atomic<std::uint32_t> remaining{static_cast<std::uint32_t>(segments.size())};
+
+    for (std::uint32_t index = 0; index < segments.size(); ++index) {
+        pool.submit([&task, &remaining, this, index] {
+            task(index);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&remaining] { return remaining == 0; });
+}
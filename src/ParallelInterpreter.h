@@ -0,0 +1,98 @@
+#ifndef PARALLEL_INTERPRETER_H
+#define PARALLEL_INTERPRETER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "FlatProgram.h"
+#include "OutputBuffer.h"
+#include "WorkStealingPool.h"
+
+/**
+ * ParallelInterpreter class executes a program's independent statements concurrently.
+ *
+ * Single statements are too small to schedule one by one, so runs of consecutive statements are grouped into
+ * segments of a few thousand nodes. A dependency graph over the segments orders every pair that touches the same
+ * variable with at least one write: a read after a write, a write after a read, and a write after a write. A
+ * segment is queued on a WorkStealingPool as soon as the segments it depends on have finished, and executes its
+ * statements in order exactly as the Interpreter would. Printed values are collected per segment and written in
+ * source order as the segments complete.
+ */
+class ParallelInterpreter {
+public:
+    /**
+     * Initializes the interpreter with a reference to a flat program and the pool to run it on.
+     *
+     * @param program - the program to be executed
+     * @param pool - the pool executing the segments
+     * @param output - the buffer receiving printed values
+     */
+    ParallelInterpreter(const FlatProgram& program, WorkStealingPool& pool, OutputBuffer& output);
+
+    /**
+     * Executes the program, returning once every statement has run and every value has been printed.
+     */
+    void execute();
+
+private:
+    static constexpr std::uint32_t SEGMENT_NODES = 4096;  // Nodes per segment, at statement boundaries
+
+    /**
+     * Struct holding a segment's statements, the variables it touches, and its place in the graph.
+     */
+    struct Segment {
+        std::uint32_t firstStatement = 0;         // Index of the segment's first statement
+        std::uint32_t endStatement = 0;           // Index one past its last statement
+        std::vector<std::uint32_t> reads;         // Slots read, sorted and unique
+        std::vector<std::uint32_t> writes;        // Slots written, sorted and unique
+        std::vector<std::uint32_t> successors;    // Segments that depend on this one
+        std::atomic<std::uint32_t> waiting{0};    // Predecessors that have not finished
+        std::vector<Value> printed;               // Values printed by the segment, in order
+        bool done = false;                        // Set once the segment has run; guarded by mutex
+    };
+
+    /**
+     * Splits the statements into segments.
+     */
+    void createSegments();
+
+    /**
+     * Collects the variables a segment reads and writes.
+     *
+     * @param segment - the segment
+     */
+    void collectAccesses(Segment& segment) const;
+
+    /**
+     * Adds the dependency edges between segments, visiting them in program order.
+     */
+    void linkSegments();
+
+    /**
+     * Runs a segment's statements, records it as done, and queues every successor that became ready.
+     *
+     * @param index - the segment
+     */
+    void runSegment(std::uint32_t index);
+
+    /**
+     * Runs a task for every segment on the pool and waits for all of them.
+     *
+     * @param task - the work to do for a segment index
+     */
+    template <typename Task>
+    void forEachSegment(Task task);
+
+    const FlatProgram& program;                      // Reference to the program to be interpreted
+    WorkStealingPool& pool;                          // Pool executing the segments
+    OutputBuffer& output;                            // Buffer receiving printed values, written in program order
+    std::vector<std::unique_ptr<Segment>> segments;  // Segments in program order
+    std::vector<Value> slots;                        // Stores variable values, indexed by slot
+    std::mutex mutex;                                // Guards the segments' done flags and finished
+    std::condition_variable finished;                // Signalled when a segment is done
+};
+
+#endif // PARALLEL_INTERPRETER_H
@@ -1,10 +1,14 @@
 #include "Parser.h"
 #include <iostream>
 #include "AST.h"
-#include <memory>
 
-// Constructor initializes the parser with a token sequence
-Parser::Parser(const std::vector<Token>& tokens) : tokens(tokens), current(0) {}
+// Constructor initializes the parser with a token sequence and the arena that will own the AST
+Parser::Parser(const std::vector<Token>& tokens, Arena& arena, std::ostream& diagnostics)
+    : tokens(&tokens), arena(arena), diagnostics(diagnostics) {}
+
+// Constructor initializes the parser with a lexer to pull tokens from, reading the first one
+Parser::Parser(Lexer& lexer, Arena& arena, std::ostream& diagnostics)
+    : lexer(&lexer), lookahead(lexer.next()), arena(arena), diagnostics(diagnostics) {}
 
 /**
  * Parses the tokens and constructs an Abstract Syntax Tree (AST).
@@ -12,55 +16,66 @@ Parser::Parser(const std::vector<Token>& tokens) : tokens(tokens), current(0) {}
  *
  * @param ast - pointer to a vector where AST nodes will be stored
  */
-void Parser::parse(std::vector<std::unique_ptr<ASTNode>> *ast) {
+void Parser::parse(std::vector<ASTNode*> *ast) {
     while (!isAtEnd()) {
-        // Parse 'let' statements
-        if (tokens[current].type == TokenType::LET) {
-            consume(TokenType::LET);  // Consume 'let' keyword
-            ast->push_back(parseLetStatement());
-        }
-        // Parse 'show' statements
-        else if (tokens[current].type == TokenType::SHOW) {
-            consume(TokenType::SHOW);  // Consume 'show' keyword
-            ast->push_back(parseShowStatement());
-        } else {
-            // Handle unexpected tokens with an error message
-            std::cerr << "Error: Unexpected token " << tokens[current].lexeme << "\n";
-            current++;
+        if (ASTNode* statement = parseStatement()) {
+            ast->push_back(statement);
         }
     }
 }
 
+/**
+ * Parses a single 'let' or 'show' statement.
+ *
+ * @return an AST node representing the statement, or null if it could not be parsed
+ */
+ASTNode* Parser::parseStatement() {
+    // Parse 'let' statements
+    if (peek().type == TokenType::LET) {
+        consume(TokenType::LET);  // Consume 'let' keyword
+        return parseLetStatement();
+    }
+    // Parse 'show' statements
+    if (peek().type == TokenType::SHOW) {
+        consume(TokenType::SHOW);  // Consume 'show' keyword
+        return parseShowStatement();
+    }
+    // Handle unexpected tokens with an error message
+    error() << "Unexpected token " << peek().lexeme << "\n";
+    advance();
+    return nullptr;
+}
+
 /**
  * Parses a 'let' statement, expecting an identifier, '=', and an expression.
  *
  * @return an AST node representing the assignment
  */
-std::unique_ptr<ASTNode> Parser::parseLetStatement() {
-    if (isAtEnd() || tokens[current].type != TokenType::IDENTIFIER) {
-        std::cerr << "Error: Expected identifier after 'let'\n";
+ASTNode* Parser::parseLetStatement() {
+    if (isAtEnd() || peek().type != TokenType::IDENTIFIER) {
+        error() << "Expected identifier after 'let'\n";
         return nullptr;
     }
-    std::string var = tokens[current++].lexeme;  // Capture the variable name
+    const std::string_view var = advance().lexeme;  // Capture the variable name
     consume(TokenType::EQUALS);  // Expect and consume '='
 
-    auto value = expression();  // Parse the expression for assignment
+    ASTNode* value = expression();  // Parse the expression for assignment
 
     // Confirm expression is valid
     if (!value) {
-        std::cerr << "Error: Expression in 'let' statement is null.\n";
+        error() << "Expression in 'let' statement is null.\n";
         return nullptr;
     }
     if (value->value.empty() && value->type != BINARY_OP) {
-        std::cerr << "Error: Expression value is empty in 'let' statement for variable: " << var << "\n";
+        error() << "Expression value is empty in 'let' statement for variable: " << var << "\n";
         return nullptr;
     }
     consume(TokenType::SEMICOLON);  // Expect and consume ';' to end the statement
 
     // Create and return an AST node for the assignment
-    std::vector<std::unique_ptr<ASTNode>> children;
-    children.push_back(std::move(value));
-    return std::make_unique<ASTNode>(ASSIGN, var, std::move(children));
+    ASTNode* assignment = makeNode(ASSIGN, var, 1);
+    assignment->children[0] = value;
+    return assignment;
 }
 
 /**
@@ -68,20 +83,20 @@ std::unique_ptr<ASTNode> Parser::parseLetStatement() {
  *
  * @return an AST node representing the print operation
  */
-std::unique_ptr<ASTNode> Parser::parseShowStatement() {
-    if (isAtEnd() || tokens[current].type != TokenType::IDENTIFIER) {
-        std::cerr << "Error: Expected identifier after 'show'\n";
+ASTNode* Parser::parseShowStatement() {
+    if (isAtEnd() || peek().type != TokenType::IDENTIFIER) {
+        error() << "Expected identifier after 'show'\n";
         return nullptr;
     }
-    std::string var = tokens[current++].lexeme;  // Capture the variable name
+    const std::string_view var = advance().lexeme;  // Capture the variable name
 
-    if (!isAtEnd() && tokens[current].type == TokenType::SEMICOLON) {
+    if (!isAtEnd() && peek().type == TokenType::SEMICOLON) {
         consume(TokenType::SEMICOLON);  // Expect and consume ';'
     } else {
-        std::cerr << "Error: Expected ';' at the end of 'show' statement\n";
+        error() << "Expected ';' at the end of 'show' statement\n";
         return nullptr;
     }
-    return std::make_unique<ASTNode>(PRINT, var);
+    return makeNode(PRINT, var);
 }
 
 /**
@@ -89,38 +104,57 @@ std::unique_ptr<ASTNode> Parser::parseShowStatement() {
  *
  * @return an AST node representing the expression
  */
-std::unique_ptr<ASTNode> Parser::expression() {
-    std::unique_ptr<ASTNode> left;
+ASTNode* Parser::expression() {
+    ASTNode* left;
 
     // Parse the left operand
-    if (tokens[current].type == TokenType::IDENTIFIER) {
-        std::string firstOperand = tokens[current++].lexeme;
-        left = std::make_unique<ASTNode>(IDENTIFIER, firstOperand);
-    } else if (tokens[current].type == TokenType::NUMBER) {  // Handle numeric literals
-        std::string numberValue = tokens[current++].lexeme;
-        left = std::make_unique<ASTNode>(NUMBER, numberValue);
+    if (peek().type == TokenType::IDENTIFIER) {
+        left = makeNode(IDENTIFIER, advance().lexeme);
+    } else if (peek().type == TokenType::NUMBER) {  // Handle numeric literals
+        left = makeNode(NUMBER, advance().lexeme);
     } else {
-        std::cerr << "Error: Expected identifier or number, got " << tokens[current].lexeme << "\n";
+        error() << "Expected identifier or number, got " << peek().lexeme << "\n";
         return nullptr;
     }
 
     // Parse binary operators and right operands
-    while (!isAtEnd() && (tokens[current].type == TokenType::PLUS || tokens[current].type == TokenType::MINUS)) {
-        char op = tokens[current++].lexeme[0];  // Capture the operator
+    while (!isAtEnd() && (peek().type == TokenType::PLUS || peek().type == TokenType::MINUS)) {
+        char op = advance().lexeme[0];  // Capture the operator
 
         // Parse right operand (identifier or number)
-        if (tokens[current].type == TokenType::IDENTIFIER || tokens[current].type == TokenType::NUMBER) {
-            std::string rightOperand = tokens[current++].lexeme;
-            auto right = std::make_unique<ASTNode>(tokens[current - 1].type == TokenType::IDENTIFIER ? IDENTIFIER : NUMBER, rightOperand);
-            left = std::make_unique<BinaryOpNode>(std::move(left), std::move(right), op);  // Create BinaryOpNode
+        if (peek().type == TokenType::IDENTIFIER || peek().type == TokenType::NUMBER) {
+            const Token operand = advance();
+            ASTNode* right = makeNode(operand.type == TokenType::IDENTIFIER ? IDENTIFIER : NUMBER, operand.lexeme);
+
+            // Create the binary operation node with the left and right operands
+            ASTNode* binaryOp = makeNode(BINARY_OP, "", 2);
+            binaryOp->op = op;
+            binaryOp->children[0] = left;
+            binaryOp->children[1] = right;
+            left = binaryOp;
         } else {
-            std::cerr << "Error: Expected identifier or number after operator " << op << "\n";
+            error() << "Expected identifier or number after operator " << op << "\n";
             return nullptr;
         }
     }
     return left;
 }
 
+/**
+ * Allocates a node in the arena.
+ * The value is copied into the arena, so the AST does not depend on the source buffer the tokens point into.
+ *
+ * @param type - the type of the node
+ * @param value - the value associated with the node
+ * @param childCount - the number of child slots to allocate
+ * @return the new node
+ */
+ASTNode* Parser::makeNode(const NodeType type, const std::string_view value, const size_t childCount) {
+    ASTNode* node = arena.create<ASTNode>(type, arena.copyString(value));
+    node->children = arena.allocateSpan<ASTNode*>(childCount);
+    return node;
+}
+
 /**
  * Consumes a token of the specified type, advancing the parser position.
  * Logs an error if the token does not match the expected type.
@@ -128,23 +162,57 @@ std::unique_ptr<ASTNode> Parser::expression() {
  * @param type - the expected type of the next token
  */
 void Parser::consume(TokenType type) {
-    if (tokens[current].type == type) {
-        current++;
+    if (peek().type == type) {
+        advance();
     } else {
-        std::cerr << "Error: Expected token type " << static_cast<int>(type)
-                  << ", but got token " << tokens[current].lexeme
-                  << " of type " << static_cast<int>(tokens[current].type) << "\n";
-        if (tokens[current].type != TokenType::END) {
-            current++;  // Skip only if not at the end to avoid moving past the last token
-        }
+        error() << "Expected token type " << static_cast<int>(type)
+              << ", but got token " << peek().lexeme
+              << " of type " << static_cast<int>(peek().type) << "\n";
+        advance();  // Does not move past the END token
     }
 }
 
+/**
+ * Starts an error report for the current token.
+ *
+ * @return the diagnostics stream, for the rest of the message
+ */
+std::ostream& Parser::error() {
+    return diagnostics << "Error: line " << peek().line << ": ";
+}
+
 /**
  * Checks if the parser has reached the end of the token stream.
  *
  * @return true if at the end of the tokens, false otherwise
  */
 bool Parser::isAtEnd() const {
-    return current >= tokens.size() || tokens[current].type == TokenType::END;
+    return peek().type == TokenType::END;
+}
+
+/**
+ * Returns the current token, from the token vector or the lexer lookahead.
+ *
+ * @return the current token
+ */
+const Token& Parser::peek() const {
+    return tokens ? (*tokens)[current] : lookahead;
+}
+
+/**
+ * Advances to the next token. The END token is sticky: advancing past it has no effect.
+ *
+ * @return the token that was current before advancing
+ */
+Token Parser::advance() {
+    const Token token = peek();
+
+    if (token.type != TokenType::END) {
+        if (tokens) {
+            current++;
+        } else {
+            lookahead = lexer->next();
+        }
+    }
+    return token;
 }
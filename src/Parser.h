@@ -1,55 +1,100 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <iostream>
+#include <string_view>
 #include <vector>
 #include "Lexer.h"
 #include "AST.h"
-#include <memory>
 
 /**
  * The Parser class converts a sequence of tokens into an Abstract Syntax Tree (AST).
  * It processes 'let' and 'show' statements, as well as expressions with identifiers and numbers.
+ * Every node, and every name it keeps, is allocated in the caller's Arena.
+ *
+ * Tokens come either from a complete token vector or, for streaming, straight from a Lexer one at a time;
+ * in the latter case only the current token is held, and statements can be parsed one by one.
  */
 class Parser {
 public:
     /**
-     * Initializes the parser with a vector of tokens.
+     * Initializes the parser with a vector of tokens and the arena to build the AST in.
      *
      * @param tokens - a vector of tokens generated by the Lexer
+     * @param arena - the arena that will own the AST nodes
+     * @param diagnostics - stream that parse errors are reported to
      */
-    explicit Parser(const std::vector<Token>& tokens);
+    Parser(const std::vector<Token>& tokens, Arena& arena, std::ostream& diagnostics = std::cerr);
+
+    /**
+     * Initializes the parser to pull tokens on demand from a lexer.
+     *
+     * @param lexer - the lexer producing the tokens
+     * @param arena - the arena that will own the AST nodes
+     * @param diagnostics - stream that parse errors are reported to
+     */
+    Parser(Lexer& lexer, Arena& arena, std::ostream& diagnostics = std::cerr);
 
     /**
      * Parses the tokens into an AST and stores it in the provided vector.
      *
      * @param ast - pointer to a vector to store the AST nodes
      */
-    void parse(std::vector<std::unique_ptr<ASTNode>> *ast);
+    void parse(std::vector<ASTNode*> *ast);
+
+    /**
+     * Parses the next statement.
+     * Errors are reported and the offending tokens skipped, in which case null is returned.
+     *
+     * @return an AST node representing the statement, or null if it could not be parsed
+     */
+    ASTNode* parseStatement();
+
+    /**
+     * Checks if the parser has reached the end of the token stream.
+     *
+     * @return true if at the end of the tokens, false otherwise
+     */
+    [[nodiscard]] bool isAtEnd() const;
 
 private:
-    const std::vector<Token>& tokens;  // Reference to the tokenized input
-    size_t current;                    // Current position in the token stream
+    const std::vector<Token>* tokens = nullptr;  // Tokenized input, or null when reading from a lexer
+    size_t current = 0;                          // Current position in the token vector
+    Lexer* lexer = nullptr;                      // Lexer to pull tokens from, or null when reading a vector
+    Token lookahead{};                           // Current token when reading from a lexer
+    Arena& arena;                                // Arena that owns the AST nodes
+    std::ostream& diagnostics;                   // Stream that parse errors are reported to
 
     /**
      * Parses a 'let' statement, expecting an identifier and an expression.
      *
      * @return an AST node representing the assignment
      */
-    std::unique_ptr<ASTNode> parseLetStatement();
+    ASTNode* parseLetStatement();
 
     /**
      * Parses a 'show' statement, expecting an identifier to be displayed.
      *
      * @return an AST node representing the print operation
      */
-    std::unique_ptr<ASTNode> parseShowStatement();
+    ASTNode* parseShowStatement();
 
     /**
      * Parses an expression, could include binary operations and literals.
      *
      * @return an AST node representing the expression
      */
-    std::unique_ptr<ASTNode> expression();
+    ASTNode* expression();
+
+    /**
+     * Allocates a node in the arena, copying its value out of the token stream.
+     *
+     * @param type - the type of the node
+     * @param value - the value associated with the node
+     * @param childCount - the number of child slots to allocate
+     * @return the new node
+     */
+    ASTNode* makeNode(NodeType type, std::string_view value, size_t childCount = 0);
 
     /**
      * Consumes a token of the specified type, advancing the parser position.
@@ -60,11 +105,25 @@ private:
     void consume(TokenType type);
 
     /**
-     * Checks if the parser has reached the end of the token stream.
+     * Starts an error report for the current token, prefixed with its line number.
      *
-     * @return true if at the end of the tokens, false otherwise
+     * @return the diagnostics stream, for the rest of the message
      */
-    [[nodiscard]] bool isAtEnd() const;
+    std::ostream& error();
+
+    /**
+     * Returns the current token without advancing.
+     *
+     * @return the current token
+     */
+    [[nodiscard]] const Token& peek() const;
+
+    /**
+     * Advances to the next token, never moving past the END token.
+     *
+     * @return the token that was current before advancing
+     */
+    Token advance();
 };
 
 #endif // PARSER_H
@@ -0,0 +1,45 @@
+#include "ProgramCache.h"
+
+// Constructor initializes an empty cache with the given capacity
+ProgramCache::ProgramCache(const std::size_t capacity) : capacity(capacity) {}
+
+/**
+ * Finds a program and moves its entry to the front of the list.
+ *
+ * @param key - the program's key
+ * @return the program, or nullptr if it is not cached
+ */
+std::shared_ptr<const CachedProgram> ProgramCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto found = index.find(key);
+
+    if (found == index.end()) {
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, found->second);
+    return found->second->second;
+}
+
+/**
+ * Puts the program at the front of the list, replacing any entry with the same key, and drops entries from the
+ * back while there are more than the capacity.
+ *
+ * @param key - the program's key
+ * @param program - the program
+ */
+void ProgramCache::insert(const std::string& key, std::shared_ptr<const CachedProgram> program) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto found = index.find(key);
+
+    if (found != index.end()) {
+        found->second->second = std::move(program);
+        entries.splice(entries.begin(), entries, found->second);
+    } else {
+        entries.emplace_front(key, std::move(program));
+        index.emplace(key, entries.begin());
+    }
+    while (entries.size() > capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
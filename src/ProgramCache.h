@@ -0,0 +1,61 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "Bytecode.h"
+
+/**
+ * Struct holding a loaded script ready to run: its bytecode and the parse errors reported while loading it,
+ * which are replayed every time it runs.
+ */
+struct CachedProgram {
+    Chunk chunk;              // The compiled program
+    std::string diagnostics;  // Parse errors reported while loading
+};
+
+/**
+ * ProgramCache class keeps the most recently used compiled programs, up to a fixed number, so repeated runs of
+ * a script skip loading it. Programs are immutable once cached and shared with every run that uses them, so an
+ * evicted program stays alive until its last run finishes. All operations are thread-safe.
+ */
+class ProgramCache {
+public:
+    /**
+     * Initializes an empty cache.
+     *
+     * @param capacity - the most programs kept; 0 keeps none
+     */
+    explicit ProgramCache(std::size_t capacity);
+
+    /**
+     * Looks a program up and marks it as the most recently used.
+     *
+     * @param key - the program's key
+     * @return the program, or nullptr if it is not cached
+     */
+    std::shared_ptr<const CachedProgram> find(const std::string& key);
+
+    /**
+     * Adds or replaces a program as the most recently used, evicting the least recently used beyond capacity.
+     *
+     * @param key - the program's key
+     * @param program - the program
+     */
+    void insert(const std::string& key, std::shared_ptr<const CachedProgram> program);
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const CachedProgram>>;
+
+    std::size_t capacity;                                                 // Most programs kept
+    std::list<Entry> entries;                                             // Programs, most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;   // Entry of each key
+    std::mutex mutex;                                                     // Guards entries and index
+};
+
+#endif // PROGRAM_CACHE_H
@@ -0,0 +1,142 @@
+#include "RegisterAllocator.h"
+#include <algorithm>
+
+// Constructor initializes the allocator with a flat program and the number of available registers
+RegisterAllocator::RegisterAllocator(const FlatProgram& program, const std::uint8_t registerCount,
+                                     const bool liveAtExit)
+    : program(program), registerCount(registerCount), liveAtExit(liveAtExit) {}
+
+/**
+ * Computes the location of every variable access: intervals are built, allocated, and then mapped back onto the
+ * nodes that read or write them by replaying the program.
+ *
+ * @return the location of each node's value
+ */
+std::vector<std::int8_t> RegisterAllocator::allocate() {
+    buildIntervals();
+    scan();
+
+    std::vector<std::int8_t> locations(program.size(), IN_MEMORY);
+    std::vector<std::uint32_t> current(program.slotNames.size(), NO_VALUE);
+    std::uint32_t next = 0;
+
+    forEachAccess(
+        [&](const std::uint32_t node, const std::uint32_t slot, std::uint32_t) {
+            // A variable read before any assignment (never produced by the Resolver) reads its zeroed memory
+            locations[node] = current[slot] == NO_VALUE ? IN_MEMORY : intervals[current[slot]].location;
+        },
+        [&](const std::uint32_t node, const std::uint32_t slot, std::uint32_t) {
+            current[slot] = next;
+            locations[node] = intervals[next++].location;
+        });
+
+    finalLocations.assign(program.slotNames.size(), UNUSED);
+    for (std::size_t slot = 0; slot < current.size(); ++slot) {
+        if (current[slot] != NO_VALUE) {
+            finalLocations[slot] = intervals[current[slot]].location;
+        }
+    }
+    return locations;
+}
+
+/**
+ * Replays the variable accesses of the program in execution order.
+ *
+ * @param read - callback for IDENTIFIER and PRINT nodes
+ * @param define - callback for ASSIGN nodes
+ */
+template <typename Read, typename Define>
+void RegisterAllocator::forEachAccess(Read read, Define define) const {
+    for (std::uint32_t statement = 0; statement < program.statements.size(); ++statement) {
+        const std::uint32_t root = program.statements[statement];
+
+        for (std::uint32_t node = program.statementStart(statement); node < root; ++node) {
+            if (program.kinds[node] == IDENTIFIER) {
+                read(node, program.operands[node], statement);
+            }
+        }
+        if (program.kinds[root] == ASSIGN) {
+            define(root, program.operands[root], statement);
+        } else {
+            read(root, program.operands[root], statement);
+        }
+    }
+}
+
+/**
+ * Builds the live intervals with a forward pass, tracking the value currently held by each slot.
+ */
+void RegisterAllocator::buildIntervals() {
+    std::vector<std::uint32_t> current(program.slotNames.size(), NO_VALUE);
+
+    intervals.clear();
+    forEachAccess(
+        [&](std::uint32_t, const std::uint32_t slot, const std::uint32_t statement) {
+            if (current[slot] != NO_VALUE) {
+                intervals[current[slot]].end = statement;
+                intervals[current[slot]].used = true;
+            }
+        },
+        [&](std::uint32_t, const std::uint32_t slot, const std::uint32_t statement) {
+            current[slot] = static_cast<std::uint32_t>(intervals.size());
+            intervals.push_back({statement, statement, false, UNUSED});
+        });
+
+    // Final values are read by a virtual statement after the last one
+    if (liveAtExit) {
+        for (const std::uint32_t value : current) {
+            if (value != NO_VALUE) {
+                intervals[value].end = static_cast<std::uint32_t>(program.statements.size());
+                intervals[value].used = true;
+            }
+        }
+    }
+}
+
+/**
+ * Linear-scan allocation. Active intervals are kept sorted by end; an interval expires once the statement that
+ * starts the next one is reached, since a statement reads its operands before it writes its result. When no
+ * register is free, whichever of the active intervals and the new one ends last is spilled.
+ */
+void RegisterAllocator::scan() {
+    std::vector<std::uint32_t> active;
+    std::vector<std::int8_t> freeRegisters;
+
+    for (int reg = registerCount - 1; reg >= 0; --reg) {
+        freeRegisters.push_back(static_cast<std::int8_t>(reg));
+    }
+
+    const auto byEnd = [this](const std::uint32_t a, const std::uint32_t b) {
+        return intervals[a].end < intervals[b].end;
+    };
+
+    for (std::uint32_t index = 0; index < intervals.size(); ++index) {
+        Interval& interval = intervals[index];
+
+        if (!interval.used) {
+            continue;
+        }
+
+        // Expire intervals whose last read is no later than this interval's assignment
+        auto expired = active.begin();
+        while (expired != active.end() && intervals[*expired].end <= interval.start) {
+            freeRegisters.push_back(intervals[*expired].location);
+            ++expired;
+        }
+        active.erase(active.begin(), expired);
+
+        if (!freeRegisters.empty()) {
+            interval.location = freeRegisters.back();
+            freeRegisters.pop_back();
+        } else if (!active.empty() && intervals[active.back()].end > interval.end) {
+            // Steal the register of the interval that ends last and send that one to memory instead
+            interval.location = intervals[active.back()].location;
+            intervals[active.back()].location = IN_MEMORY;
+            active.pop_back();
+        } else {
+            interval.location = IN_MEMORY;
+            continue;
+        }
+        active.insert(std::upper_bound(active.begin(), active.end(), index, byEnd), index);
+    }
+}
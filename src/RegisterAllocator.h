@@ -0,0 +1,86 @@
+#ifndef REGISTER_ALLOCATOR_H
+#define REGISTER_ALLOCATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "FlatProgram.h"
+
+/**
+ * The RegisterAllocator class decides where each variable value of a FlatProgram lives during compiled execution.
+ *
+ * Every assignment starts a new value of its variable, live from that statement to the last statement that reads
+ * it before the variable is reassigned. Because programs are straight-line code, these live intervals come out of
+ * a single forward pass already sorted by start, and a linear scan hands out registers in the same order. When
+ * registers run out, the value whose interval ends furthest away is spilled to the variable's memory slot.
+ */
+class RegisterAllocator {
+public:
+    static constexpr std::int8_t IN_MEMORY = -1;  // The value lives in its variable's memory slot
+    static constexpr std::int8_t UNUSED = -2;     // The value is never read, so it need not be stored at all
+
+    /**
+     * Initializes the allocator for a program and a number of available registers.
+     *
+     * @param program - the program whose variables are allocated
+     * @param registerCount - number of general-purpose registers the allocator may hand out
+     * @param liveAtExit - whether the final value of every variable is read after the last statement, as when
+     *                     the caller inspects the variables once the code returns
+     */
+    RegisterAllocator(const FlatProgram& program, std::uint8_t registerCount, bool liveAtExit = false);
+
+    /**
+     * Computes the location of every variable access in the program.
+     *
+     * @return for each node, the register index (0 to registerCount - 1), IN_MEMORY or UNUSED of the value an
+     *         IDENTIFIER or PRINT node reads or an ASSIGN node writes; other nodes are left as IN_MEMORY
+     */
+    [[nodiscard]] std::vector<std::int8_t> allocate();
+
+    /**
+     * Returns where the final value of each variable is when the program ends, after allocate().
+     *
+     * @return for each slot, the register index or IN_MEMORY; UNUSED for slots the program never assigns
+     */
+    [[nodiscard]] const std::vector<std::int8_t>& exitLocations() const { return finalLocations; }
+
+private:
+    /**
+     * Struct describing the live interval of one value, in statement positions.
+     */
+    struct Interval {
+        std::uint32_t start;     // Statement that assigns the value
+        std::uint32_t end;       // Last statement that reads the value
+        bool used;               // Whether any statement reads the value
+        std::int8_t location;    // Register index, IN_MEMORY or UNUSED
+    };
+
+    static constexpr std::uint32_t NO_VALUE = UINT32_MAX;  // Slot not assigned yet
+
+    /**
+     * Calls read(node, slot, statement) for every variable read and define(node, slot, statement) for every
+     * assignment, in execution order: the reads of a statement come before its assignment.
+     *
+     * @param read - callback for IDENTIFIER and PRINT nodes
+     * @param define - callback for ASSIGN nodes
+     */
+    template <typename Read, typename Define>
+    void forEachAccess(Read read, Define define) const;
+
+    /**
+     * Builds the live interval of every value.
+     */
+    void buildIntervals();
+
+    /**
+     * Assigns a register or memory to every used interval with a linear scan.
+     */
+    void scan();
+
+    const FlatProgram& program;          // Reference to the program being allocated
+    const std::uint8_t registerCount;    // Number of registers available
+    const bool liveAtExit;               // Whether final values are read after the program
+    std::vector<Interval> intervals;     // Live intervals, in order of their start
+    std::vector<std::int8_t> finalLocations;  // Location of each slot's final value
+};
+
+#endif // REGISTER_ALLOCATOR_H
@@ -0,0 +1,92 @@
+#include "Resolver.h"
+#include <stdexcept>
+
+// Constructor initializes the resolver with the slot name table to fill in
+Resolver::Resolver(std::vector<std::string>& slotNames) : names(4096), slotNames(slotNames) {}
+
+/**
+ * Walks the statements in program order, binding each variable to a slot.
+ *
+ * @param nodes - the AST nodes produced by the Parser
+ */
+void Resolver::resolve(const std::vector<ASTNode*>& nodes) {
+    for (ASTNode* node : nodes) {
+        if (node) {
+            resolveStatement(*node);  // Statements the parser rejected are null
+        }
+    }
+}
+
+/**
+ * Creates a slot for an input variable, so that reads of it resolve.
+ *
+ * @param name - the variable's name
+ */
+void Resolver::declareInput(const std::string_view name) {
+    if (slots.find(name) == slots.end()) {
+        slots.emplace(names.copyString(name), static_cast<int>(slotNames.size()));
+        slotNames.emplace_back(name);
+    }
+}
+
+/**
+ * Binds the variables of one statement to slots.
+ * An assignment's expression is resolved before its target, so 'let a = a + 1;' still needs an earlier 'a'.
+ *
+ * @param node - the statement's ASSIGN or PRINT node
+ */
+void Resolver::resolveStatement(ASTNode& node) {
+    if (node.type == ASSIGN) {
+        if (node.children.size() == 1) {
+            resolveExpression(*node.children[0]);
+        }
+        // Slots are only created by assignments and input declarations, so every slot that exists has a value
+        auto it = slots.find(node.value);
+
+        if (it == slots.end()) {
+            it = slots.emplace(names.copyString(node.value), static_cast<int>(slotNames.size())).first;
+            slotNames.emplace_back(node.value);
+        }
+        node.slot = it->second;
+    } else if (node.type == PRINT) {
+        resolveRead(node);
+    }
+}
+
+/**
+ * Resolves every identifier inside an expression node.
+ * Uses an explicit worklist rather than recursion, since operator chains can be arbitrarily deep.
+ *
+ * @param node - AST node representing the expression
+ */
+void Resolver::resolveExpression(ASTNode& node) {
+    std::vector<ASTNode*> pending{&node};
+
+    while (!pending.empty()) {
+        ASTNode* current = pending.back();
+        pending.pop_back();
+
+        if (current->type == IDENTIFIER) {
+            resolveRead(*current);
+        }
+        // Push children right to left so the leftmost undefined variable is the one reported
+        for (size_t i = current->children.size(); i > 0; --i) {
+            pending.push_back(current->children[i - 1]);
+        }
+    }
+}
+
+/**
+ * Binds a variable read to its slot.
+ * The program is straight-line code, so a read before any assignment is always an error.
+ *
+ * @param node - the IDENTIFIER or PRINT node reading the variable
+ */
+void Resolver::resolveRead(ASTNode& node) {
+    const auto it = slots.find(node.value);
+
+    if (it == slots.end()) {
+        throw std::runtime_error("Undefined variable: " + std::string(node.value));
+    }
+    node.slot = it->second;
+}
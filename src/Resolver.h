@@ -0,0 +1,69 @@
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "AST.h"
+
+/**
+ * The Resolver class runs after parsing and binds every variable reference to a dense slot index.
+ * Reads of variables that have not been assigned yet are rejected here, before anything executes,
+ * so the engines can index a flat slot array without hashing or runtime checks.
+ * Statements can be resolved all at once or one at a time as they are parsed.
+ */
+class Resolver {
+public:
+    /**
+     * Initializes the resolver with the table that receives the name of each new slot.
+     *
+     * @param slotNames - the slot name table, appended to as new variables are assigned
+     */
+    explicit Resolver(std::vector<std::string>& slotNames);
+
+    /**
+     * Assigns a slot to every identifier, assignment and print node of a program.
+     * Throws if a variable is read before it has been assigned.
+     *
+     * @param nodes - the AST nodes produced by the Parser
+     */
+    void resolve(const std::vector<ASTNode*>& nodes);
+
+    /**
+     * Declares a variable that the script may read before assigning it, because its value comes from outside.
+     * Declaring the same name twice has no further effect.
+     *
+     * @param name - the variable's name
+     */
+    void declareInput(std::string_view name);
+
+    /**
+     * Assigns slots within a single statement, following every statement resolved before it.
+     * Throws if a variable is read before it has been assigned.
+     *
+     * @param node - the statement's ASSIGN or PRINT node
+     */
+    void resolveStatement(ASTNode& node);
+
+private:
+    Arena names;                                      // Owns the map keys, which outlive the ASTs being resolved
+    std::unordered_map<std::string_view, int> slots;  // Variable name to slot index
+    std::vector<std::string>& slotNames;              // Variable name for each slot
+
+    /**
+     * Resolves the variable reads inside an expression node.
+     *
+     * @param node - AST node representing the expression
+     */
+    void resolveExpression(ASTNode& node);
+
+    /**
+     * Resolves a variable read, throwing if it has not been assigned before this point.
+     *
+     * @param node - the IDENTIFIER or PRINT node reading the variable
+     */
+    void resolveRead(ASTNode& node);
+};
+
+#endif // RESOLVER_H
@@ -0,0 +1,202 @@
+#include "Scanner.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define LITESCRIPT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(LITESCRIPT_SSE2) && defined(__GNUC__)
+#define LITESCRIPT_AVX2 1  // Compiled with a target attribute and selected at runtime
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Character classes the scanners can look for
+enum class CharClass { SPACE, ALPHA, DIGIT };
+
+using ScanFunction = std::size_t (*)(const char*, std::size_t, std::size_t);
+
+/**
+ * Returns the index of the lowest set bit of a non-zero mask.
+ *
+ * @param mask - a non-zero bit mask
+ * @return the number of trailing zero bits
+ */
+inline unsigned countTrailingZeros(const unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * Classifies a single character.
+ *
+ * @param c - the character to classify
+ * @return true if the character belongs to the class
+ */
+template <CharClass K>
+bool matches(const char c) {
+    if constexpr (K == CharClass::SPACE) return isAsciiSpace(c);
+    if constexpr (K == CharClass::ALPHA) return isAsciiAlpha(c);
+    return isAsciiDigit(c);
+}
+
+/**
+ * Scans one character at a time; used for tails and on hosts without SIMD.
+ */
+template <CharClass K>
+std::size_t scanScalar(const char* data, std::size_t position, const std::size_t length) {
+    while (position < length && matches<K>(data[position])) ++position;
+    return position;
+}
+
+#ifdef LITESCRIPT_SSE2
+
+/**
+ * Classifies 16 bytes at once, returning 0xFF in each lane that belongs to the class.
+ * Ranges are tested as (c - low) <= (high - low) in unsigned arithmetic, via min_epu8.
+ */
+template <CharClass K>
+__m128i classify16(const __m128i bytes) {
+    if constexpr (K == CharClass::SPACE) {
+        const __m128i offset = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+        const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8('\r' - '\t')), offset);
+        return _mm_or_si128(control, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+    }
+    if constexpr (K == CharClass::ALPHA) {
+        const __m128i lower = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+        const __m128i offset = _mm_sub_epi8(lower, _mm_set1_epi8('a'));
+        return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8('z' - 'a')), offset);
+    }
+    const __m128i offset = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(9)), offset);
+}
+
+/**
+ * Scans 16 bytes per step with SSE2, finishing the last partial block with the scalar loop.
+ */
+template <CharClass K>
+std::size_t scanSse2(const char* data, std::size_t position, const std::size_t length) {
+    while (position + 16 <= length) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+        const unsigned outside = ~static_cast<unsigned>(_mm_movemask_epi8(classify16<K>(bytes))) & 0xFFFFu;
+
+        if (outside) {
+            return position + countTrailingZeros(outside);
+        }
+        position += 16;
+    }
+    return scanScalar<K>(data, position, length);
+}
+
+#endif
+
+#ifdef LITESCRIPT_AVX2
+
+/**
+ * Classifies 32 bytes at once; the AVX2 counterpart of classify16.
+ */
+template <CharClass K>
+__attribute__((target("avx2"))) __m256i classify32(const __m256i bytes) {
+    if constexpr (K == CharClass::SPACE) {
+        const __m256i offset = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+        const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8('\r' - '\t')), offset);
+        return _mm256_or_si256(control, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')));
+    }
+    if constexpr (K == CharClass::ALPHA) {
+        const __m256i lower = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+        const __m256i offset = _mm256_sub_epi8(lower, _mm256_set1_epi8('a'));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8('z' - 'a')), offset);
+    }
+    const __m256i offset = _mm256_sub_epi8(bytes, _mm256_set1_epi8('0'));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(9)), offset);
+}
+
+/**
+ * Scans 32 bytes per step with AVX2, handing the remainder to the SSE2 scanner.
+ */
+template <CharClass K>
+__attribute__((target("avx2"))) std::size_t scanAvx2(const char* data, std::size_t position, const std::size_t length) {
+    while (position + 32 <= length) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+        const unsigned outside = ~static_cast<unsigned>(_mm256_movemask_epi8(classify32<K>(bytes)));
+
+        if (outside) {
+            return position + countTrailingZeros(outside);
+        }
+        position += 32;
+    }
+    return scanSse2<K>(data, position, length);
+}
+
+#endif
+
+/**
+ * Picks the widest scanner the running CPU supports. Called on first use, from a function-local static, so
+ * lexing from another translation unit's static initializer never sees an unselected scanner.
+ */
+template <CharClass K>
+ScanFunction selectScanner() {
+#ifdef LITESCRIPT_AVX2
+    __builtin_cpu_init();  // May run during static initialization, before the CPU model is otherwise set up
+    if (__builtin_cpu_supports("avx2")) return scanAvx2<K>;
+#endif
+#ifdef LITESCRIPT_SSE2
+    return scanSse2<K>;
+#else
+    return scanScalar<K>;
+#endif
+}
+
+}  // namespace
+
+/**
+ * Finds the end of a run of whitespace.
+ * Most runs are a single space, so the first character is checked before entering the vector loop.
+ *
+ * @param data - the source buffer
+ * @param position - where the run starts
+ * @param length - the length of the source buffer
+ * @return the index of the first non-whitespace character at or after position, or length
+ */
+std::size_t scanWhitespace(const char* data, std::size_t position, const std::size_t length) {
+    if (position >= length || !isAsciiSpace(data[position])) return position;
+    if (++position >= length || !isAsciiSpace(data[position])) return position;
+    static const ScanFunction whitespaceScanner = selectScanner<CharClass::SPACE>();
+    return whitespaceScanner(data, position, length);
+}
+
+/**
+ * Finds the end of a run of letters.
+ *
+ * @param data - the source buffer
+ * @param position - where the run starts
+ * @param length - the length of the source buffer
+ * @return the index of the first non-letter at or after position, or length
+ */
+std::size_t scanAlpha(const char* data, const std::size_t position, const std::size_t length) {
+    static const ScanFunction alphaScanner = selectScanner<CharClass::ALPHA>();
+    return alphaScanner(data, position, length);
+}
+
+/**
+ * Finds the end of a run of digits.
+ *
+ * @param data - the source buffer
+ * @param position - where the run starts
+ * @param length - the length of the source buffer
+ * @return the index of the first non-digit at or after position, or length
+ */
+std::size_t scanDigits(const char* data, const std::size_t position, const std::size_t length) {
+    static const ScanFunction digitScanner = selectScanner<CharClass::DIGIT>();
+    return digitScanner(data, position, length);
+}
@@ -0,0 +1,76 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <cstddef>
+
+/**
+ * Character classification and run scanning used by the Lexer.
+ *
+ * The classes match the C-locale behaviour of isspace/isalpha/isdigit but are plain ASCII range
+ * checks, so they are branch-light and independent of the current locale. The scan functions find
+ * the end of a run of one class; on x86-64 they classify 16 (SSE2) or 32 (AVX2, when the CPU has it)
+ * bytes per step, with a scalar loop for the tail and for other architectures.
+ */
+
+/**
+ * Checks for whitespace: space, '\t', '\n', '\v', '\f' or '\r'.
+ *
+ * @param c - the character to classify
+ * @return true if the character is whitespace
+ */
+inline bool isAsciiSpace(const char c) {
+    const auto u = static_cast<unsigned char>(c);
+    return u == ' ' || static_cast<unsigned char>(u - '\t') <= '\r' - '\t';
+}
+
+/**
+ * Checks for an ASCII letter.
+ *
+ * @param c - the character to classify
+ * @return true if the character is in [A-Za-z]
+ */
+inline bool isAsciiAlpha(const char c) {
+    return static_cast<unsigned char>((static_cast<unsigned char>(c) | 0x20) - 'a') <= 'z' - 'a';
+}
+
+/**
+ * Checks for an ASCII digit.
+ *
+ * @param c - the character to classify
+ * @return true if the character is in [0-9]
+ */
+inline bool isAsciiDigit(const char c) {
+    return static_cast<unsigned char>(c - '0') <= 9;
+}
+
+/**
+ * Finds the end of a run of whitespace.
+ *
+ * @param data - the source buffer
+ * @param position - where the run starts
+ * @param length - the length of the source buffer
+ * @return the index of the first non-whitespace character at or after position, or length
+ */
+std::size_t scanWhitespace(const char* data, std::size_t position, std::size_t length);
+
+/**
+ * Finds the end of a run of letters.
+ *
+ * @param data - the source buffer
+ * @param position - where the run starts
+ * @param length - the length of the source buffer
+ * @return the index of the first non-letter at or after position, or length
+ */
+std::size_t scanAlpha(const char* data, std::size_t position, std::size_t length);
+
+/**
+ * Finds the end of a run of digits.
+ *
+ * @param data - the source buffer
+ * @param position - where the run starts
+ * @param length - the length of the source buffer
+ * @return the index of the first non-digit at or after position, or length
+ */
+std::size_t scanDigits(const char* data, std::size_t position, std::size_t length);
+
+#endif // SCANNER_H
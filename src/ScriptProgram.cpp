@@ -0,0 +1,64 @@
+#include "ScriptProgram.h"
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "LiteScript.h"
+#include "SourceFile.h"
+#include "VM.h"
+
+// Constructor initializes the handle over the shared bytecode
+ScriptProgram::ScriptProgram(std::shared_ptr<const Chunk> chunk) : chunk(std::move(chunk)) {}
+
+/**
+ * Loads the script with a LiteScript of its own, collecting parse errors instead of printing them: the command
+ * line runs whatever statements parsed, but an embedded script that lost statements is rejected. A resolution
+ * error is reported along with them.
+ *
+ * @param source - the script's source text
+ * @param optLevel - the optimization level
+ * @return the compiled program
+ */
+ScriptProgram ScriptProgram::compile(const std::string_view source, const int optLevel) {
+    if (optLevel < 0 || optLevel > Optimizer::MAX_LEVEL) {
+        throw std::runtime_error("Invalid optimization level: " + std::to_string(optLevel));
+    }
+    std::ostringstream diagnostics;
+    LiteScript script;
+    script.setDiagnostics(diagnostics);
+    try {
+        script.loadSource(source, 1, optLevel);
+    } catch (const std::runtime_error& error) {
+        diagnostics << error.what() << '\n';  // Reported after the parse errors that may have caused it
+    }
+
+    std::string errors = diagnostics.str();
+    if (!errors.empty()) {
+        if (errors.back() == '\n') {
+            errors.pop_back();
+        }
+        throw std::runtime_error(errors);
+    }
+    return ScriptProgram(std::make_shared<const Chunk>(script.bytecode()));
+}
+
+/**
+ * Maps the source file and compiles its text.
+ *
+ * @param filename - the name of the source file
+ * @param optLevel - the optimization level
+ * @return the compiled program
+ */
+ScriptProgram ScriptProgram::compileFile(const std::string& filename, const int optLevel) {
+    const SourceFile source(filename);
+    return compile(source.view(), optLevel);
+}
+
+/**
+ * Runs the bytecode on a VM local to this call.
+ *
+ * @param sink - the sink receiving shown values
+ */
+void ScriptProgram::run(OutputSink& sink) const {
+    VM vm(chunk->view(), sink);
+    vm.execute();
+}
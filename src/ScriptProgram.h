@@ -0,0 +1,59 @@
+#ifndef SCRIPT_PROGRAM_H
+#define SCRIPT_PROGRAM_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include "Bytecode.h"
+#include "Optimizer.h"
+#include "OutputSink.h"
+
+/**
+ * ScriptProgram class is the entry point for programs that embed LiteScript: a script compiled once, then run
+ * any number of times, from any number of threads at once.
+ *
+ * A program is an immutable handle to the script's bytecode, so copies are cheap and share it. Every run gets
+ * its own VM, with its own variables and operand stack, and reports shown values to the sink the caller passes
+ * in; nothing is shared between runs but the bytecode, so concurrent runs need no locking.
+ */
+class ScriptProgram {
+public:
+    /**
+     * Compiles a script from its text.
+     * Throws std::runtime_error, carrying every parse error, if the script does not compile cleanly.
+     *
+     * @param source - the script's source text, which need only stay valid during the call
+     * @param optLevel - the optimization level, from 0 (none) to Optimizer::MAX_LEVEL
+     * @return the compiled program
+     */
+    static ScriptProgram compile(std::string_view source, int optLevel = Optimizer::MAX_LEVEL);
+
+    /**
+     * Compiles a script from a source file, exactly as compile does from text.
+     *
+     * @param filename - the name of the source file
+     * @param optLevel - the optimization level, from 0 (none) to Optimizer::MAX_LEVEL
+     * @return the compiled program
+     */
+    static ScriptProgram compileFile(const std::string& filename, int optLevel = Optimizer::MAX_LEVEL);
+
+    /**
+     * Runs the program from the start with all of its variables fresh. Safe to call concurrently.
+     * An exception thrown by the sink stops the run and is passed on to the caller.
+     *
+     * @param sink - the sink receiving the values of show statements, in order
+     */
+    void run(OutputSink& sink) const;
+
+private:
+    /**
+     * Initializes the handle over compiled bytecode.
+     *
+     * @param chunk - the bytecode, shared by every copy of the handle
+     */
+    explicit ScriptProgram(std::shared_ptr<const Chunk> chunk);
+
+    std::shared_ptr<const Chunk> chunk;  // Bytecode shared by every copy and run; never modified
+};
+
+#endif // SCRIPT_PROGRAM_H
@@ -0,0 +1,314 @@
+#include "ScriptServer.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+
+// Unix domain sockets and POSIX signals are not available; the server cannot be started
+ScriptServer::ScriptServer(ServerOptions options) : options(std::move(options)), cache(0) {
+    throw std::runtime_error("serve is only supported on POSIX systems");
+}
+
+ScriptServer::~ScriptServer() = default;
+
+void ScriptServer::serve() {}
+
+void ScriptServer::handle(int) {}
+
+std::shared_ptr<const CachedProgram> ScriptServer::load(const std::string&, const std::string&) { return nullptr; }
+
+void ScriptServer::readRequest(int, std::string&, std::string&) {}
+
+void ScriptServer::sendAll(int, std::string_view) {}
+
+#else
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "ContentHash.h"
+#include "LiteScript.h"
+#include "OutputBuffer.h"
+#include "ThreadPool.h"
+#include "VM.h"
+
+namespace {
+    volatile std::sig_atomic_t stopRequested = 0;  // Set by SIGINT or SIGTERM
+
+    /**
+     * Signal handler asking the accept loop to stop.
+     */
+    void requestStop(int) {
+        stopRequested = 1;
+    }
+}
+
+/**
+ * Binds the socket and listens on it. A socket already at the path is replaced only if nothing accepts
+ * connections on it, so a second server cannot take over a running one's path. The listening socket is
+ * non-blocking, since serve only accepts after select reports a waiting connection.
+ *
+ * @param options - the server's settings
+ */
+ScriptServer::ScriptServer(ServerOptions options) : options(std::move(options)), cache(this->options.cacheSize) {
+    const std::string& path = this->options.socketPath;
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    struct stat info {};
+    if (lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error("Not a socket: " + path);
+        }
+        const int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        const bool live = probe >= 0 && connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (live) {
+            throw std::runtime_error("Another server is listening on " + path);
+        }
+        unlink(path.c_str());
+    }
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || listen(listener, SOMAXCONN) != 0 || fcntl(listener, F_SETFL, O_NONBLOCK) != 0) {
+        const std::string reason = std::strerror(errno);
+        if (listener >= 0) {
+            close(listener);
+        }
+        throw std::runtime_error("Could not listen on " + path + ": " + reason);
+    }
+
+    // A client that disconnects early must fail that request's writes, not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+}
+
+// Destructor closes the listening socket and removes its path
+ScriptServer::~ScriptServer() {
+    close(listener);
+    unlink(options.socketPath.c_str());
+}
+
+/**
+ * Runs the accept loop. SIGINT and SIGTERM are blocked everywhere except inside pselect, which unblocks them
+ * atomically: a stop signal therefore always interrupts the wait, and never lands on a worker thread. The pool
+ * is destroyed on return, which finishes every accepted request first.
+ */
+void ScriptServer::serve() {
+    sigset_t stopSignals;
+    sigset_t previous;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, &previous);  // Inherited by the workers created below
+
+    struct sigaction action {};
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    sigset_t waitMask = previous;
+    sigdelset(&waitMask, SIGINT);
+    sigdelset(&waitMask, SIGTERM);
+
+    ThreadPool pool(options.threads);
+
+    while (!stopRequested) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(listener, &readable);
+
+        if (pselect(listener + 1, &readable, nullptr, nullptr, nullptr, &waitMask) < 0) {
+            if (errno == EINTR) {
+                continue;  // Stopping, or an unrelated signal
+            }
+            throw std::runtime_error(std::string("Could not wait for connections: ") + std::strerror(errno));
+        }
+        const int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            continue;  // The connection went away before it was accepted
+        }
+        fcntl(client, F_SETFL, fcntl(client, F_GETFL) & ~O_NONBLOCK);  // Some systems inherit the listener's flag
+        pool.submit([this, client] { handle(client); });
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+
+/**
+ * Handles one connection. The output goes through an OutputBuffer writing to the socket, so results stream
+ * back in large blocks as the script runs; the buffer is destroyed, writing what it holds, before any error
+ * message is sent. Both directions time out, so a client that stops reading cannot hold a worker forever: the
+ * buffer records the failed write and skips the rest of the output.
+ *
+ * @param client - the connected socket
+ */
+void ScriptServer::handle(const int client) {
+    timeval timeout{};
+    timeout.tv_sec = REQUEST_TIMEOUT_SECONDS;
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    try {
+        std::string kind;
+        std::string argument;
+        readRequest(client, kind, argument);
+
+        const std::shared_ptr<const CachedProgram> program = load(kind, argument);
+        sendAll(client, program->diagnostics);
+
+        OutputBuffer output(client);
+        VM vm(program->chunk.view(), output);
+        vm.execute();
+        try {
+            output.flush();
+        } catch (const std::runtime_error&) {
+            // The client stopped reading or went away, so an error message would only wait out another timeout
+        }
+    } catch (const std::exception& e) {
+        sendAll(client, std::string("Error: ") + e.what() + "\n");
+    }
+    close(client);
+}
+
+/**
+ * Looks the program up in the cache, keyed by path and modification time for files and by a content hash for
+ * text; on a miss, loads and compiles it on this worker and caches it. Two requests missing on the same script
+ * at once both load it, and the second to finish replaces the first's identical entry.
+ *
+ * @param kind - "PATH" or "TEXT"
+ * @param argument - the script's path or text
+ * @return the program
+ */
+std::shared_ptr<const CachedProgram> ScriptServer::load(const std::string& kind, const std::string& argument) {
+    std::string key;
+
+    if (kind == "PATH") {
+        std::error_code error;
+        const auto modified = std::filesystem::last_write_time(argument, error);
+        if (error) {
+            throw std::runtime_error("Could not open file: " + argument);
+        }
+        key = "PATH " + argument + "\n" + std::to_string(modified.time_since_epoch().count());
+    } else {
+        ContentHash hash;
+        hash.add(argument);
+        key = "TEXT " + hash.hex();
+    }
+    if (std::shared_ptr<const CachedProgram> cached = cache.find(key)) {
+        return cached;
+    }
+
+    std::ostringstream diagnostics;
+    LiteScript script;
+    script.setDiagnostics(diagnostics);
+    if (kind == "PATH") {
+        script.loadFile(argument, 1, options.optLevel);  // Requests already run in parallel; parse each on one thread
+    } else {
+        script.loadSource(argument, 1, options.optLevel);
+    }
+
+    auto program = std::make_shared<CachedProgram>();
+    program->chunk = script.bytecode();
+    program->diagnostics = diagnostics.str();
+    cache.insert(key, program);
+    return program;
+}
+
+/**
+ * Reads the request line, then for TEXT requests exactly the announced number of bytes of script. The script
+ * grows as bytes arrive, so memory follows what the client actually sends rather than what it announces.
+ *
+ * @param client - the connected socket
+ * @param kind - receives "PATH" or "TEXT"
+ * @param argument - receives the path or the script text
+ */
+void ScriptServer::readRequest(const int client, std::string& kind, std::string& argument) {
+    std::string received;
+    char block[4096];
+    std::size_t newline;
+
+    while ((newline = received.find('\n')) == std::string::npos) {
+        if (received.size() > MAX_REQUEST_LINE) {
+            throw std::runtime_error("Request line too long");
+        }
+        const ssize_t count = recv(client, block, sizeof(block), 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            throw std::runtime_error("Incomplete request");
+        }
+        received.append(block, static_cast<std::size_t>(count));
+    }
+
+    const std::string line = received.substr(0, newline);
+    const std::size_t space = line.find(' ');
+    kind = line.substr(0, space);
+    argument = space == std::string::npos ? "" : line.substr(space + 1);
+
+    if (kind == "PATH" && !argument.empty()) {
+        return;
+    }
+    if (kind != "TEXT" || argument.empty() || argument.size() > 18
+        || argument.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::runtime_error("Malformed request: " + line);
+    }
+
+    const std::size_t length = std::stoull(argument);
+    if (length > MAX_TEXT_SIZE) {
+        throw std::runtime_error("Script too long: " + argument + " bytes; send larger scripts as PATH requests");
+    }
+    argument.assign(received, newline + 1, std::min(received.size() - newline - 1, length));
+
+    while (argument.size() < length) {
+        const ssize_t count = recv(client, block, std::min(sizeof(block), length - argument.size()), 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            throw std::runtime_error("Incomplete request");
+        }
+        argument.append(block, static_cast<std::size_t>(count));
+    }
+}
+
+/**
+ * Writes text with as many system calls as needed, giving up quietly if the client has gone away; SIGPIPE is
+ * ignored, so that shows up as a failed send.
+ *
+ * @param client - the connected socket
+ * @param text - the text to write
+ */
+void ScriptServer::sendAll(const int client, std::string_view text) {
+    while (!text.empty()) {
+        const ssize_t written = send(client, text.data(), text.size(), 0);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return;
+        }
+        text.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SCRIPT_SERVER_H
+#define SCRIPT_SERVER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "Optimizer.h"
+#include "ProgramCache.h"
+
+/**
+ * Struct holding the settings of a ScriptServer.
+ */
+struct ServerOptions {
+    std::string socketPath;               // Path of the Unix domain socket to listen on
+    unsigned threads = 0;                 // Worker threads running scripts; 0 uses one per hardware thread
+    std::size_t cacheSize = 64;           // Compiled programs kept between requests
+    int optLevel = Optimizer::MAX_LEVEL;  // Optimization level scripts are loaded with
+};
+
+/**
+ * ScriptServer class runs scripts for clients of a Unix domain socket, so a job runner pays for process startup
+ * once rather than once per script.
+ *
+ * Each connection carries one request, a line naming a script file or giving the length of script text that
+ * follows:
+ *
+ *     PATH /absolute/path/to/script.ls\n
+ *     TEXT 42\n<42 bytes of script>
+ *
+ * The server streams back exactly what `litescript interpret` would print: parse errors, then one
+ * "Result: N" line per show statement, then "Error: <message>" if the script failed. It closes the connection
+ * when done. Requests run concurrently on a thread pool, each on its own VM over a compiled program shared
+ * through a ProgramCache. Files are cached by path and modification time, so an edited file is loaded again;
+ * script text is cached by a hash of its content.
+ */
+class ScriptServer {
+public:
+    /**
+     * Creates the socket and starts listening. A stale socket left at the path by an earlier server is
+     * replaced; any other file there is an error. Throws if the socket cannot be created.
+     *
+     * @param options - the server's settings
+     */
+    explicit ScriptServer(ServerOptions options);
+
+    // Closes the socket and removes it from the file system
+    ~ScriptServer();
+
+    ScriptServer(const ScriptServer&) = delete;
+    ScriptServer& operator=(const ScriptServer&) = delete;
+
+    /**
+     * Accepts and runs requests until the process receives SIGINT or SIGTERM, then waits for the requests
+     * already accepted to finish.
+     */
+    void serve();
+
+private:
+    static constexpr int REQUEST_TIMEOUT_SECONDS = 30;     // Longest wait for a client to send or accept data
+    static constexpr std::size_t MAX_REQUEST_LINE = 8192;  // Longest request line, path included
+    static constexpr std::size_t MAX_TEXT_SIZE = 64 << 20; // Longest script a TEXT request may send
+
+    /**
+     * Reads a request, runs its script, streams the output back, and closes the connection.
+     *
+     * @param client - the connected socket
+     */
+    void handle(int client);
+
+    /**
+     * Returns the compiled program for a request, from the cache or by loading and compiling it.
+     *
+     * @param kind - "PATH" or "TEXT"
+     * @param argument - the script's path or text
+     * @return the program
+     */
+    std::shared_ptr<const CachedProgram> load(const std::string& kind, const std::string& argument);
+
+    /**
+     * Reads a request from a client. Throws if it is malformed, incomplete, or announces too long a script.
+     *
+     * @param client - the connected socket
+     * @param kind - receives "PATH" or "TEXT"
+     * @param argument - receives the path or the script text
+     */
+    static void readRequest(int client, std::string& kind, std::string& argument);
+
+    /**
+     * Writes text to a client, ignoring a client that has gone away.
+     *
+     * @param client - the connected socket
+     * @param text - the text to write
+     */
+    static void sendAll(int client, std::string_view text);
+
+    ServerOptions options;  // The server's settings
+    ProgramCache cache;     // Compiled programs of recent requests
+    int listener = -1;      // The listening socket
+};
+
+#endif // SCRIPT_SERVER_H
@@ -0,0 +1,109 @@
+#include "ShardedParser.h"
+#include <algorithm>
+#include <future>
+#include <iostream>
+#include "Lexer.h"
+#include "Parser.h"
+
+// Sources are not split into shards smaller than this, since each shard has a fixed cost
+constexpr std::size_t MIN_SHARD_SIZE = 256 * 1024;
+
+// Shards per worker thread, so uneven shards still balance across the pool
+constexpr std::size_t SHARDS_PER_THREAD = 4;
+
+// Constructor initializes the parser with the source and the pool to run on
+ShardedParser::ShardedParser(const std::string_view source, ThreadPool& pool, std::ostream& diagnostics)
+    : source(source), pool(pool), diagnostics(diagnostics) {}
+
+/**
+ * Splits the source, numbers the lines of each shard, then lexes and parses the shards in parallel.
+ *
+ * @param ast - pointer to a vector to store the AST nodes
+ */
+void ShardedParser::parse(std::vector<ASTNode*>* ast) {
+    split();
+
+    // Count newlines per shard in parallel, then turn the counts into each shard's first line number
+    std::vector<std::uint32_t> newlines(shards.size());
+    forEachShard([&](const std::size_t index) {
+        const std::string_view text = shards[index]->text;
+        newlines[index] = static_cast<std::uint32_t>(std::count(text.begin(), text.end(), '\n'));
+    });
+    for (std::size_t i = 1; i < shards.size(); ++i) {
+        shards[i]->firstLine = shards[i - 1]->firstLine + newlines[i - 1];
+    }
+
+    // Lex and parse each shard into its own arena, buffering its diagnostics and any lexical error
+    forEachShard([&](const std::size_t index) {
+        Shard& shard = *shards[index];
+
+        try {
+            Lexer lexer(shard.text, shard.firstLine);
+            Parser parser(lexer, shard.arena, shard.diagnostics);
+            parser.parse(&shard.statements);
+        } catch (...) {
+            shard.failure = std::current_exception();
+        }
+    });
+
+    // A sequential parse lexes the whole source before parsing any of it, so a lexical error is reported alone:
+    // the earliest one is rethrown and every buffered diagnostic dropped
+    for (const auto& shard : shards) {
+        if (shard->failure) {
+            std::rethrow_exception(shard->failure);
+        }
+    }
+
+    // Join in source order, replaying each shard's diagnostics
+    for (const auto& shard : shards) {
+        diagnostics << shard->diagnostics.str();
+        ast->insert(ast->end(), shard->statements.begin(), shard->statements.end());
+    }
+}
+
+/**
+ * Cuts the source into shards. Each cut is placed just after the first ';' at or beyond the even split
+ * point, so no statement or token is ever divided between shards.
+ */
+void ShardedParser::split() {
+    const std::size_t wanted = std::max<std::size_t>(1, pool.size() * SHARDS_PER_THREAD);
+    const std::size_t count = std::clamp<std::size_t>(source.size() / MIN_SHARD_SIZE, 1, wanted);
+    const std::size_t target = source.size() / count;
+    std::size_t start = 0;
+
+    for (std::size_t i = 1; i < count && start < source.size(); ++i) {
+        const std::size_t semicolon = source.find(';', std::max(start, i * target));
+
+        if (semicolon == std::string_view::npos) break;
+
+        auto shard = std::make_unique<Shard>();
+        shard->text = source.substr(start, semicolon + 1 - start);
+        shards.push_back(std::move(shard));
+        start = semicolon + 1;
+    }
+    auto last = std::make_unique<Shard>();
+    last->text = source.substr(start);
+    shards.push_back(std::move(last));
+}
+
+/**
+ * Runs a task for every shard on the pool and waits for all of them before returning or rethrowing,
+ * so no task is still using a shard when the caller moves on.
+ *
+ * @param task - the work to run for each shard, given the shard's index
+ */
+template <typename Task>
+void ShardedParser::forEachShard(Task task) {
+    std::vector<std::future<void>> pending;
+    pending.reserve(shards.size());
+
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        pending.push_back(pool.submit([&task, i] { task(i); }));
+    }
+    for (std::future<void>& result : pending) {
+        result.wait();
+    }
+    for (std::future<void>& result : pending) {
+        result.get();  // Rethrows the earliest shard's exception, if any
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef SHARDED_PARSER_H
+#define SHARDED_PARSER_H
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string_view>
+#include <vector>
+#include "AST.h"
+#include "ThreadPool.h"
+
+/**
+ * The ShardedParser class lexes and parses a large source on several threads.
+ *
+ * Every statement ends with ';', and ';' appears nowhere else, so the source can be cut just after a ';'
+ * into shards that parse independently. Each shard is lexed and parsed on the thread pool into its own
+ * arena, with line numbers offset so diagnostics report positions in the whole file, and the per-shard
+ * statements are then joined in source order.
+ */
+class ShardedParser {
+public:
+    /**
+     * Initializes the parser with the source to split and the pool to run shards on.
+     *
+     * @param source - the whole source; it must outlive the parser
+     * @param pool - the thread pool the shards are processed on
+     * @param diagnostics - stream that parse errors are reported to
+     */
+    ShardedParser(std::string_view source, ThreadPool& pool, std::ostream& diagnostics = std::cerr);
+
+    /**
+     * Parses every shard in parallel and appends their statements, in source order, to the provided vector.
+     * Parse errors are reported to the diagnostics stream in source order; if any shard hit a lexical error, the
+     * first one is rethrown instead and no parse error is reported, as in a sequential parse.
+     * The nodes are owned by this parser, which must outlive them.
+     *
+     * @param ast - pointer to a vector to store the AST nodes
+     */
+    void parse(std::vector<ASTNode*>* ast);
+
+private:
+    // A statement-aligned slice of the source and everything parsed from it
+    struct Shard {
+        std::string_view text;              // The slice of the source
+        std::uint32_t firstLine = 1;        // Line number of the slice's first character
+        Arena arena;                        // Owns the shard's AST nodes
+        std::vector<ASTNode*> statements;   // The shard's statements, in order
+        std::ostringstream diagnostics;     // Parse errors, replayed in order after the join
+        std::exception_ptr failure;         // Lexical error that stopped the shard, if any
+    };
+
+    std::string_view source;                     // The whole source
+    ThreadPool& pool;                            // Pool the shards run on
+    std::ostream& diagnostics;                   // Stream that parse errors are reported to
+    std::vector<std::unique_ptr<Shard>> shards;  // Shards in source order
+
+    /**
+     * Cuts the source into shards of roughly equal size, each ending just after a ';'.
+     */
+    void split();
+
+    /**
+     * Runs a task for every shard on the pool and waits for all of them.
+     * If any task throws, the exception of the earliest such shard is rethrown after all have finished.
+     *
+     * @param task - the work to run for each shard
+     */
+    template <typename Task>
+    void forEachShard(Task task);
+};
+
+#endif // SHARDED_PARSER_H
@@ -0,0 +1,84 @@
+#include "SourceFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+/**
+ * Reads the whole file into an owned buffer.
+ *
+ * @param filename - the name of the source file to open
+ */
+SourceFile::SourceFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+}
+
+SourceFile::~SourceFile() = default;
+
+#else
+
+/**
+ * Maps the whole file read-only into memory.
+ * Empty files are not mapped, since mmap rejects zero-length mappings.
+ *
+ * @param filename - the name of the source file to open
+ */
+SourceFile::SourceFile(const std::string& filename) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    struct stat info {};
+
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Could not read file: " + filename);
+    }
+    size = static_cast<std::size_t>(info.st_size);
+
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Could not map file: " + filename);
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);  // The lexer reads the source front to back once
+        data = static_cast<const char*>(mapping);
+    }
+    close(fd);  // The mapping stays valid after the descriptor is closed
+}
+
+SourceFile::~SourceFile() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+#endif
+
+/**
+ * Returns a view over the whole file contents.
+ *
+ * @return the file contents
+ */
+std::string_view SourceFile::view() const {
+    return {data, size};
+}
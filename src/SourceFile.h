@@ -0,0 +1,44 @@
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * SourceFile class gives read-only access to the contents of a script file.
+ * On POSIX systems the file is memory-mapped, so the source is never copied and tokens can point
+ * straight into the mapping; elsewhere the file is read into a buffer once.
+ */
+class SourceFile {
+public:
+    /**
+     * Opens and maps the given file.
+     * Throws if the file cannot be opened or mapped.
+     *
+     * @param filename - the name of the source file to open
+     */
+    explicit SourceFile(const std::string& filename);
+
+    // Releases the mapping
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    /**
+     * Returns a view over the whole file contents, valid for the lifetime of this object.
+     *
+     * @return the file contents
+     */
+    [[nodiscard]] std::string_view view() const;
+
+private:
+    const char* data = nullptr;  // Start of the mapped (or buffered) contents
+    std::size_t size = 0;        // Length of the contents in bytes
+#ifdef _WIN32
+    std::string buffer;          // Owned copy of the contents where mmap is unavailable
+#endif
+};
+
+#endif // SOURCE_FILE_H
@@ -0,0 +1,73 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+// Constructor starts the requested number of workers (at least one)
+ThreadPool::ThreadPool(std::size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threadCount);
+
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+// Destructor lets the workers drain the queue, then joins them
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Queues a task and wakes one worker.
+ *
+ * @param task - the work to run on a worker thread
+ * @return a future that becomes ready when the task has finished
+ */
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> result = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(packaged));
+    }
+    available.notify_one();
+    return result;
+}
+
+/**
+ * Returns the number of worker threads.
+ *
+ * @return the worker count
+ */
+std::size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+/**
+ * Takes tasks off the queue and runs them until the pool is stopping and no work is left.
+ */
+void ThreadPool::work() {
+    for (;;) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+            if (tasks.empty()) {
+                return;  // Stopping, and nothing left to run
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();  // Exceptions are captured in the task's future
+    }
+}
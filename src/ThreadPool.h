@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool class runs submitted tasks on a fixed set of worker threads.
+ * Tasks are taken from a shared FIFO queue; each submission returns a future that reports completion
+ * and rethrows any exception the task threw.
+ */
+class ThreadPool {
+public:
+    /**
+     * Starts the worker threads.
+     *
+     * @param threadCount - number of workers; 0 uses one per hardware thread
+     */
+    explicit ThreadPool(std::size_t threadCount = 0);
+
+    // Finishes the queued tasks and joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Queues a task for execution.
+     *
+     * @param task - the work to run on a worker thread
+     * @return a future that becomes ready when the task has finished
+     */
+    std::future<void> submit(std::function<void()> task);
+
+    /**
+     * Returns the number of worker threads.
+     *
+     * @return the worker count
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    std::vector<std::thread> workers;             // Worker threads
+    std::queue<std::packaged_task<void()>> tasks; // Tasks waiting for a worker
+    std::mutex mutex;                             // Guards tasks and stopping
+    std::condition_variable available;            // Signalled when a task is queued or the pool stops
+    bool stopping = false;                        // Set when the pool is being destroyed
+
+    /**
+     * Worker loop: runs queued tasks until the pool stops and the queue is empty.
+     */
+    void work();
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,45 @@
+#include "VM.h"
+
+// Constructor sizes the slot array and operand stack for the given chunk
+VM::VM(const ChunkView& chunk, OutputSink& output)
+    : chunk(chunk), output(output), slots(chunk.slotCount), stack(chunk.maxStack) {}
+
+/**
+ * Runs the dispatch loop over the instruction stream.
+ * Undefined variables are rejected by the Resolver, so no checks are made here.
+ */
+void VM::execute() {
+    const Instruction* ip = chunk.code;
+    const Value* constants = chunk.constants;
+    Value* vars = slots.data();
+    Value* sp = stack.data();  // Points one past the top of the operand stack
+
+    for (;;) {
+        const Instruction instruction = *ip++;
+
+        switch (instruction.op) {
+            case OpCode::LOAD_CONST:
+                *sp++ = constants[instruction.operand];
+                break;
+            case OpCode::LOAD_SLOT:
+                *sp++ = vars[instruction.operand];
+                break;
+            case OpCode::ADD:
+                --sp;
+                sp[-1] = wrappingAdd(sp[-1], *sp);
+                break;
+            case OpCode::SUB:
+                --sp;
+                sp[-1] = wrappingSub(sp[-1], *sp);
+                break;
+            case OpCode::STORE:
+                vars[instruction.operand] = *--sp;
+                break;
+            case OpCode::SHOW:
+                output.writeResult(vars[instruction.operand]);
+                break;
+            case OpCode::HALT:
+                return;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef VM_H
+#define VM_H
+
+#include <vector>
+#include "Bytecode.h"
+#include "OutputSink.h"
+
+/**
+ * VM class executes compiled bytecode in a single dispatch loop, from a Chunk or a mapped bytecode file.
+ * Variables live in a flat slot array and intermediate values on a preallocated operand stack.
+ */
+class VM {
+public:
+    /**
+     * Initializes the VM with the chunk to execute.
+     *
+     * @param chunk - the compiled bytecode, which must outlive the VM
+     * @param output - the sink receiving printed values
+     */
+    VM(const ChunkView& chunk, OutputSink& output);
+
+    /**
+     * Executes the chunk from the first instruction until HALT.
+     */
+    void execute();
+
+private:
+    ChunkView chunk;           // The bytecode being executed
+    OutputSink& output;        // Sink receiving printed values
+    std::vector<Value> slots;  // Variable values, indexed by slot
+    std::vector<Value> stack;  // Operand stack, sized to the chunk's maximum depth
+};
+
+#endif // VM_H
@@ -0,0 +1,31 @@
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <cstdint>
+
+// Type of every LiteScript value: a 64-bit signed integer
+using Value = std::int64_t;
+
+/**
+ * Adds two values with two's-complement wraparound, matching what compiled code does on overflow.
+ *
+ * @param left - the left operand
+ * @param right - the right operand
+ * @return the wrapped sum
+ */
+inline Value wrappingAdd(const Value left, const Value right) {
+    return static_cast<Value>(static_cast<std::uint64_t>(left) + static_cast<std::uint64_t>(right));
+}
+
+/**
+ * Subtracts two values with two's-complement wraparound.
+ *
+ * @param left - the left operand
+ * @param right - the right operand
+ * @return the wrapped difference
+ */
+inline Value wrappingSub(const Value left, const Value right) {
+    return static_cast<Value>(static_cast<std::uint64_t>(left) - static_cast<std::uint64_t>(right));
+}
+
+#endif // VALUE_H
@@ -0,0 +1,126 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+    thread_local const WorkStealingPool* currentPool = nullptr;  // Pool the calling thread works for, if any
+    thread_local std::size_t currentQueue = 0;                   // That worker's queue
+}
+
+// Constructor starts the requested number of workers (at least one), each with its own queue
+WorkStealingPool::WorkStealingPool(std::size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    queues.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    workers.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&WorkStealingPool::work, this, i);
+    }
+}
+
+// Destructor lets the workers drain the queues, then joins them
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Queues a task on the calling worker's own queue, or on the next queue in turn when called from outside the
+ * pool, and wakes one worker. The task is counted before it becomes visible, so a worker that takes it can
+ * never drive the count below zero, and a stopping worker never sees a count of zero with a task still queued.
+ *
+ * @param task - the work to run on a worker thread
+ */
+void WorkStealingPool::submit(std::function<void()> task) {
+    const std::size_t index = currentPool == this ? currentQueue : nextQueue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++queued;
+    }
+    try {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        --queued;  // Never queued, so no worker will take it
+        throw;
+    }
+    available.notify_one();
+}
+
+/**
+ * Returns the number of worker threads.
+ *
+ * @return the worker count
+ */
+std::size_t WorkStealingPool::size() const {
+    return workers.size();
+}
+
+/**
+ * Runs tasks until the pool is stopping and no work is left, sleeping while every queue is empty.
+ *
+ * @param index - the worker's queue
+ */
+void WorkStealingPool::work(const std::size_t index) {
+    currentPool = this;
+    currentQueue = index;
+
+    for (;;) {
+        std::function<void()> task;
+
+        if (take(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --queued;
+            }
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this] { return stopping || queued > 0; });
+
+        if (stopping && queued == 0) {
+            return;  // Stopping, and nothing left to run
+        }
+    }
+}
+
+/**
+ * Takes a task, trying the worker's own queue first and then every other queue once.
+ *
+ * @param index - the worker's queue
+ * @param task - receives the task
+ * @return true if a task was taken
+ */
+bool WorkStealingPool::take(const std::size_t index, std::function<void()>& task) {
+    for (std::size_t offset = 0; offset < queues.size(); ++offset) {
+        Queue& queue = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (offset == 0) {
+            task = std::move(queue.tasks.back());  // Own queue: newest first
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());  // Steal the oldest
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
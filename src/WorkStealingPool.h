@@ -0,0 +1,86 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkStealingPool class runs tasks on a fixed set of worker threads, each with its own deque.
+ * A task submitted from a worker goes to that worker's deque, which it drains newest first, so the work a task
+ * unlocks runs on the same core while its data is still in cache. An idle worker steals the oldest task of
+ * another. Tasks submitted from outside the pool are spread round-robin.
+ *
+ * Unlike ThreadPool, submission returns no future: tasks are expected to report their own completion and must
+ * not throw.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * Starts the worker threads.
+     *
+     * @param threadCount - number of workers; 0 uses one per hardware thread
+     */
+    explicit WorkStealingPool(std::size_t threadCount = 0);
+
+    // Finishes the queued tasks and joins the workers
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * Queues a task for execution.
+     *
+     * @param task - the work to run on a worker thread
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Returns the number of worker threads.
+     *
+     * @return the worker count
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    /**
+     * Struct holding one worker's tasks.
+     */
+    struct Queue {
+        std::deque<std::function<void()>> tasks;  // Tasks, newest at the back
+        std::mutex mutex;                          // Guards tasks
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;  // One queue per worker
+    std::vector<std::thread> workers;            // Worker threads
+    std::atomic<std::size_t> nextQueue{0};       // Queue receiving the next task submitted from outside
+    std::size_t queued = 0;                      // Tasks submitted and not yet taken; guarded by mutex
+    std::mutex mutex;                            // Guards queued and stopping
+    std::condition_variable available;           // Signalled when a task is queued or the pool stops
+    bool stopping = false;                       // Set when the pool is being destroyed
+
+    /**
+     * Worker loop: runs tasks from its own queue or stolen from others until the pool stops and no work is left.
+     *
+     * @param index - the worker's queue
+     */
+    void work(std::size_t index);
+
+    /**
+     * Takes a task: the newest from the worker's own queue, or else the oldest from another queue.
+     *
+     * @param index - the worker's queue
+     * @param task - receives the task
+     * @return true if a task was taken
+     */
+    bool take(std::size_t index, std::function<void()>& task);
+};
+
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,331 @@
+#include "X86Encoder.h"
+#include <stdexcept>
+
+namespace {
+    /**
+     * Checks whether a value can be encoded as a sign-extended 8-bit immediate or displacement.
+     */
+    bool fitsInt8(const std::int64_t value) {
+        return value >= INT8_MIN && value <= INT8_MAX;
+    }
+
+    /**
+     * Checks whether a value can be encoded as a sign-extended 32-bit immediate or displacement.
+     */
+    bool fitsInt32(const std::int64_t value) {
+        return value >= INT32_MIN && value <= INT32_MAX;
+    }
+
+    /**
+     * Returns the machine encoding of a register (0 to 15).
+     */
+    std::uint8_t registerCode(const Register reg) {
+        return static_cast<std::uint8_t>(reg);
+    }
+}
+
+// Constructor initializes the encoder with a machine program
+X86Encoder::X86Encoder(const MachineProgram& program) : program(program) {}
+
+/**
+ * Encodes every instruction, then resolves jumps and calls now that every label's offset is known.
+ */
+void X86Encoder::encode() {
+    bytes.clear();
+    branchFixups.clear();
+    symbolFixups.clear();
+    labelOffsets.assign(program.labels.size(), 0);
+
+    for (const MachineInstruction& instruction : program.code) {
+        const std::size_t firstFixup = symbolFixups.size();
+
+        encodeInstruction(instruction);
+
+        // A symbol displacement is relative to the end of the whole instruction, including any immediate after it
+        for (std::size_t i = firstFixup; i < symbolFixups.size(); ++i) {
+            symbolFixups[i].end = static_cast<std::uint32_t>(bytes.size());
+        }
+    }
+
+    for (const Fixup& fixup : branchFixups) {
+        patch(fixup.position, static_cast<std::int32_t>(labelOffsets[fixup.target]) - static_cast<std::int32_t>(fixup.end));
+    }
+}
+
+/**
+ * Patches every data reference for the final code and symbol addresses.
+ *
+ * @param codeAddress - address of the first code byte
+ * @param symbolAddresses - address of each data symbol
+ */
+void X86Encoder::link(const std::uint64_t codeAddress, const std::vector<std::uint64_t>& symbolAddresses) {
+    for (const Fixup& fixup : symbolFixups) {
+        const std::int64_t displacement = static_cast<std::int64_t>(symbolAddresses[fixup.target] - (codeAddress + fixup.end));
+
+        if (!fitsInt32(displacement)) {
+            throw std::runtime_error("Symbol out of reach of the code: " + program.symbols[fixup.target].name);
+        }
+        patch(fixup.position, static_cast<std::int32_t>(displacement));
+    }
+}
+
+/**
+ * Encodes a single instruction.
+ *
+ * @param instruction - the instruction to encode
+ */
+void X86Encoder::encodeInstruction(const MachineInstruction& instruction) {
+    const Operand& destination = instruction.destination;
+
+    switch (instruction.mnemonic) {
+        case Mnemonic::MOV:
+            encodeMove(instruction);
+            break;
+        case Mnemonic::ADD:
+            encodeArithmetic(instruction, 0x00, 0);
+            break;
+        case Mnemonic::SUB:
+            encodeArithmetic(instruction, 0x28, 5);
+            break;
+        case Mnemonic::XOR:
+            encodeArithmetic(instruction, 0x30, 6);
+            break;
+        case Mnemonic::TEST:
+            encodeModRM(instruction.width, {0x85}, registerCode(instruction.source.reg), destination);
+            break;
+        case Mnemonic::LEA:
+            encodeModRM(64, {0x8D}, registerCode(destination.reg), instruction.source);
+            break;
+        case Mnemonic::NEG:
+            encodeModRM(instruction.width, {0xF7}, 3, destination);
+            break;
+        case Mnemonic::DEC:
+            encodeModRM(instruction.width, {0xFF}, 1, destination);
+            break;
+        case Mnemonic::DIV:
+            encodeModRM(instruction.width, {0xF7}, 6, destination);
+            break;
+        case Mnemonic::MUL:
+            encodeModRM(instruction.width, {0xF7}, 4, destination);
+            break;
+        case Mnemonic::SHR:
+            encodeModRM(instruction.width, {0xC1}, 5, destination);
+            emit(static_cast<std::uint64_t>(instruction.source.immediate), 1);
+            break;
+        case Mnemonic::PUSH:
+        case Mnemonic::POP:
+            if (registerCode(destination.reg) >= 8) {
+                emit(0x41, 1);  // REX.B selects r8-r15
+            }
+            emit((instruction.mnemonic == Mnemonic::PUSH ? 0x50 : 0x58) + (registerCode(destination.reg) & 7), 1);
+            break;
+        case Mnemonic::CALL:
+            if (destination.kind == Operand::REGISTER) {
+                encodeModRM(32, {0xFF}, 2, destination);  // Indirect call; always 64-bit, so no REX.W
+            } else {
+                encodeBranch({0xE8}, destination.index);
+            }
+            break;
+        case Mnemonic::JNS:
+            encodeBranch({0x0F, 0x89}, destination.index);
+            break;
+        case Mnemonic::JNZ:
+            encodeBranch({0x0F, 0x85}, destination.index);
+            break;
+        case Mnemonic::JZ:
+            encodeBranch({0x0F, 0x84}, destination.index);
+            break;
+        case Mnemonic::JMP:
+            encodeBranch({0xE9}, destination.index);
+            break;
+        case Mnemonic::RET:
+            emit(0xC3, 1);
+            break;
+        case Mnemonic::SYSCALL:
+            emit(0x050F, 2);
+            break;
+        case Mnemonic::LABEL:
+            labelOffsets[destination.index] = static_cast<std::uint32_t>(bytes.size());
+            break;
+    }
+}
+
+/**
+ * Encodes ADD, SUB or XOR. Register and memory sources use the two ModR/M forms of the opcode; immediates use
+ * the 0x80 group, with a short 8-bit immediate whenever the value allows it.
+ *
+ * @param instruction - the instruction to encode
+ * @param base - the opcode of the r/m, reg form
+ * @param extension - the opcode extension of the immediate forms
+ */
+void X86Encoder::encodeArithmetic(const MachineInstruction& instruction, const std::uint8_t base,
+                                  const std::uint8_t extension) {
+    const Operand& destination = instruction.destination;
+    const Operand& source = instruction.source;
+    const std::uint8_t byteForm = instruction.width == 8 ? 0 : 1;
+
+    switch (source.kind) {
+        case Operand::REGISTER:
+            encodeModRM(instruction.width, {static_cast<std::uint8_t>(base + byteForm)}, registerCode(source.reg), destination);
+            return;
+        case Operand::MEMORY:
+        case Operand::SYMBOL:
+            encodeModRM(instruction.width, {static_cast<std::uint8_t>(base + 2 + byteForm)}, registerCode(destination.reg), source);
+            return;
+        case Operand::IMMEDIATE:
+            if (instruction.width == 8) {
+                encodeModRM(8, {0x80}, extension, destination);
+                emit(static_cast<std::uint64_t>(source.immediate), 1);
+            } else if (fitsInt8(source.immediate)) {
+                encodeModRM(instruction.width, {0x83}, extension, destination);
+                emit(static_cast<std::uint64_t>(source.immediate), 1);
+            } else if (fitsInt32(source.immediate)) {
+                encodeModRM(instruction.width, {0x81}, extension, destination);
+                emit(static_cast<std::uint64_t>(source.immediate), 4);
+            } else {
+                throw std::runtime_error("Immediate does not fit in 32 bits: " + std::to_string(source.immediate));
+            }
+            return;
+        default:
+            throw std::runtime_error("Unsupported operands for an arithmetic instruction");
+    }
+}
+
+/**
+ * Encodes MOV. A register loaded with a constant uses the shortest of the zero-extending 32-bit form, the
+ * sign-extended 32-bit form, and the full 64-bit immediate form.
+ *
+ * @param instruction - the instruction to encode
+ */
+void X86Encoder::encodeMove(const MachineInstruction& instruction) {
+    const Operand& destination = instruction.destination;
+    const Operand& source = instruction.source;
+    const std::uint8_t byteForm = instruction.width == 8 ? 0 : 1;
+
+    if (source.kind == Operand::REGISTER) {
+        encodeModRM(instruction.width, {static_cast<std::uint8_t>(0x88 + byteForm)}, registerCode(source.reg), destination);
+    } else if (destination.kind == Operand::REGISTER && (source.kind == Operand::MEMORY || source.kind == Operand::SYMBOL)) {
+        encodeModRM(instruction.width, {static_cast<std::uint8_t>(0x8A + byteForm)}, registerCode(destination.reg), source);
+    } else if (destination.kind == Operand::REGISTER && source.kind == Operand::IMMEDIATE && instruction.width != 8) {
+        const std::uint8_t reg = registerCode(destination.reg);
+
+        if (instruction.width == 32 || (source.immediate >= 0 && source.immediate <= UINT32_MAX)) {
+            if (reg >= 8) {
+                emit(0x41, 1);
+            }
+            emit(0xB8 + (reg & 7), 1);
+            emit(static_cast<std::uint64_t>(source.immediate), 4);
+        } else if (fitsInt32(source.immediate)) {
+            encodeModRM(64, {0xC7}, 0, destination);
+            emit(static_cast<std::uint64_t>(source.immediate), 4);
+        } else {
+            emit(0x48 | (reg >> 3), 1);
+            emit(0xB8 + (reg & 7), 1);
+            emit(static_cast<std::uint64_t>(source.immediate), 8);
+        }
+    } else if (source.kind == Operand::IMMEDIATE && instruction.width == 8) {
+        encodeModRM(8, {0xC6}, 0, destination);
+        emit(static_cast<std::uint64_t>(source.immediate), 1);
+    } else if (source.kind == Operand::IMMEDIATE && fitsInt32(source.immediate)) {
+        encodeModRM(instruction.width, {0xC7}, 0, destination);
+        emit(static_cast<std::uint64_t>(source.immediate), 4);
+    } else {
+        throw std::runtime_error("Unsupported operands for a move");
+    }
+}
+
+/**
+ * Encodes the prefix, opcode, ModR/M byte and addressing bytes shared by most instructions.
+ *
+ * @param width - operand width in bits
+ * @param opcode - the opcode bytes
+ * @param reg - register or opcode extension for the ModR/M reg field
+ * @param rm - register, memory or symbol operand
+ */
+void X86Encoder::encodeModRM(const std::uint8_t width, const std::initializer_list<std::uint8_t> opcode,
+                             const std::uint8_t reg, const Operand& rm) {
+    const std::uint8_t base = rm.kind == Operand::SYMBOL ? 0 : registerCode(rm.reg);
+    std::uint8_t rex = 0x40;
+
+    if (width == 64) {
+        rex |= 0x08;  // REX.W
+    }
+    if (reg >= 8) {
+        rex |= 0x04;  // REX.R
+    }
+    if (base >= 8) {
+        rex |= 0x01;  // REX.B
+    }
+
+    // spl, bpl, sil and dil only exist with a REX prefix; without one those encodings mean ah, ch, dh and bh
+    const bool byteRegister = width == 8 && ((rm.kind == Operand::REGISTER && base >= 4) || (reg >= 4 && reg < 8));
+    if (rex != 0x40 || byteRegister) {
+        emit(rex, 1);
+    }
+    for (const std::uint8_t byte : opcode) {
+        emit(byte, 1);
+    }
+
+    const std::uint8_t regField = static_cast<std::uint8_t>((reg & 7) << 3);
+
+    if (rm.kind == Operand::REGISTER) {
+        emit(0xC0 | regField | (base & 7), 1);
+    } else if (rm.kind == Operand::SYMBOL) {
+        emit(0x05 | regField, 1);  // mod 00, r/m 101: [rip + disp32]
+        symbolFixups.push_back({static_cast<std::uint32_t>(bytes.size()), 0, rm.index});
+        emit(0, 4);
+    } else if (rm.kind == Operand::MEMORY) {
+        // rbp and r13 have no displacement-free form, and rsp and r12 need a SIB byte
+        const std::uint8_t mod = rm.displacement == 0 && (base & 7) != 5 ? 0x00 : fitsInt8(rm.displacement) ? 0x40 : 0x80;
+
+        emit(mod | regField | (base & 7), 1);
+        if ((base & 7) == 4) {
+            emit(0x24, 1);
+        }
+        if (mod == 0x40) {
+            emit(static_cast<std::uint64_t>(rm.displacement), 1);
+        } else if (mod == 0x80) {
+            emit(static_cast<std::uint64_t>(rm.displacement), 4);
+        }
+    } else {
+        throw std::runtime_error("Unsupported operand for ModR/M encoding");
+    }
+}
+
+/**
+ * Encodes a relative jump or call; its displacement is filled in at the end of encode().
+ *
+ * @param opcode - the opcode bytes
+ * @param label - index of the target label
+ */
+void X86Encoder::encodeBranch(const std::initializer_list<std::uint8_t> opcode, const std::uint32_t label) {
+    for (const std::uint8_t byte : opcode) {
+        emit(byte, 1);
+    }
+    branchFixups.push_back({static_cast<std::uint32_t>(bytes.size()), static_cast<std::uint32_t>(bytes.size() + 4), label});
+    emit(0, 4);
+}
+
+/**
+ * Appends a little-endian value to the code.
+ *
+ * @param value - the value to append
+ * @param size - number of bytes to append
+ */
+void X86Encoder::emit(const std::uint64_t value, const int size) {
+    for (int i = 0; i < size; ++i) {
+        bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+/**
+ * Overwrites a 32-bit little-endian value in the code.
+ *
+ * @param position - offset of the value
+ * @param value - the value to write
+ */
+void X86Encoder::patch(const std::uint32_t position, const std::int32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        bytes[position + i] = static_cast<std::uint8_t>(static_cast<std::uint32_t>(value) >> (8 * i));
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef X86_ENCODER_H
+#define X86_ENCODER_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "MachineCode.h"
+
+/**
+ * The X86Encoder class translates a MachineProgram into x86-64 machine code.
+ *
+ * Encoding happens in two steps. encode() produces position-independent bytes: jumps and calls use 32-bit
+ * relative displacements that are resolved immediately, while every RIP-relative reference to a data symbol
+ * is recorded as a fixup. link() then patches those fixups once the caller has decided where the code and
+ * each symbol will live, whether that is an ELF file or memory in the current process.
+ */
+class X86Encoder {
+public:
+    /**
+     * Initializes the encoder with a reference to a machine program.
+     *
+     * @param program - the program to encode
+     */
+    explicit X86Encoder(const MachineProgram& program);
+
+    /**
+     * Encodes every instruction of the program.
+     * Throws if an instruction has an operand combination the encoder does not support.
+     */
+    void encode();
+
+    /**
+     * Resolves references to data symbols for the final addresses of the code and the symbols.
+     * Throws if a symbol is further than a 32-bit displacement away from the code.
+     *
+     * @param codeAddress - address the first code byte will be loaded at
+     * @param symbolAddresses - address of each data symbol
+     */
+    void link(std::uint64_t codeAddress, const std::vector<std::uint64_t>& symbolAddresses);
+
+    /**
+     * Returns the encoded code.
+     *
+     * @return the machine code bytes
+     */
+    [[nodiscard]] const std::vector<std::uint8_t>& code() const { return bytes; }
+
+    /**
+     * Returns the offset of a code label from the start of the code.
+     *
+     * @param label - index of the label
+     * @return its offset in bytes
+     */
+    [[nodiscard]] std::uint32_t labelOffset(std::uint32_t label) const { return labelOffsets[label]; }
+
+private:
+    /**
+     * Struct representing a 32-bit displacement to patch once a target is known.
+     */
+    struct Fixup {
+        std::uint32_t position;  // Offset of the displacement in the code
+        std::uint32_t end;       // Offset of the end of the instruction, which the displacement is relative to
+        std::uint32_t target;    // Symbol or label index
+    };
+
+    /**
+     * Encodes a single instruction.
+     *
+     * @param instruction - the instruction to encode
+     */
+    void encodeInstruction(const MachineInstruction& instruction);
+
+    /**
+     * Encodes an arithmetic or logic instruction (ADD, SUB or XOR) in any of its operand forms.
+     *
+     * @param instruction - the instruction to encode
+     * @param base - the opcode of the instruction's register-to-memory form
+     * @param extension - the opcode extension used with an immediate source
+     */
+    void encodeArithmetic(const MachineInstruction& instruction, std::uint8_t base, std::uint8_t extension);
+
+    /**
+     * Encodes a MOV instruction in any of its operand forms.
+     *
+     * @param instruction - the instruction to encode
+     */
+    void encodeMove(const MachineInstruction& instruction);
+
+    /**
+     * Encodes an instruction of the form [REX] opcode ModR/M [SIB] [displacement].
+     *
+     * @param width - operand width in bits; 64 sets REX.W
+     * @param opcode - the opcode bytes
+     * @param reg - register or opcode extension for the ModR/M reg field
+     * @param rm - register or memory operand for the ModR/M r/m field
+     */
+    void encodeModRM(std::uint8_t width, std::initializer_list<std::uint8_t> opcode, std::uint8_t reg,
+                     const Operand& rm);
+
+    /**
+     * Encodes a relative jump or call to a code label.
+     *
+     * @param opcode - the opcode bytes, followed by a 32-bit displacement
+     * @param label - index of the target label
+     */
+    void encodeBranch(std::initializer_list<std::uint8_t> opcode, std::uint32_t label);
+
+    /**
+     * Appends a little-endian value to the code.
+     *
+     * @param value - the value to append
+     * @param size - number of bytes to append
+     */
+    void emit(std::uint64_t value, int size);
+
+    /**
+     * Overwrites a 32-bit little-endian value in the code.
+     *
+     * @param position - offset of the value
+     * @param value - the value to write
+     */
+    void patch(std::uint32_t position, std::int32_t value);
+
+    const MachineProgram& program;           // Reference to the program to be encoded
+    std::vector<std::uint8_t> bytes;         // Encoded machine code
+    std::vector<std::uint32_t> labelOffsets; // Offset of each code label
+    std::vector<Fixup> branchFixups;         // Jumps and calls, resolved at the end of encode()
+    std::vector<Fixup> symbolFixups;         // Data references, resolved by link()
+};
+
+#endif // X86_ENCODER_H
@@ -1,45 +1,366 @@
+#include <cctype>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
+#include "BuildCache.h"
 #include "LiteScript.h"
+#include "Optimizer.h"
+#include "ScriptServer.h"
+
+/**
+ * Prints what value numbering removed from the loaded script to stderr, so the script's own output is unchanged.
+ *
+ * @param lite_script - the loaded script
+ */
+static void reportOptimization(const LiteScript& lite_script) {
+    const ValueNumberingReport& report = lite_script.valueNumberingReport();
+
+    if (report.instructions == 0) {
+        std::cerr << "Value numbering did not run" << std::endl;
+        return;
+    }
+    std::cerr << "Value numbering removed " << report.removed << " of " << report.instructions
+              << " IR instructions (" << report.arithmeticRemoved << " of " << report.arithmetic
+              << " additions and subtractions)" << std::endl;
+}
+
+/**
+ * Parses the text of an --input option, NAME or NAME=VALUE, where NAME is a valid variable name.
+ *
+ * @param text - the text after "--input="
+ * @param input - receives the parsed input
+ * @return whether the text was valid
+ */
+static bool parseInput(const std::string& text, InputBinding& input) {
+    const std::size_t equals = text.find('=');
+    input.name = text.substr(0, equals);
+
+    if (input.name.empty() || input.name == "let" || input.name == "show") {
+        return false;
+    }
+    for (const char c : input.name) {
+        if (!std::isalpha(static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+    if (equals == std::string::npos) {
+        input.value.reset();
+        return true;
+    }
+    const std::string value = text.substr(equals + 1);
+    const std::size_t digits = !value.empty() && value[0] == '-' ? 1 : 0;
+
+    if (value.size() == digits || value.find_first_not_of("0123456789", digits) != std::string::npos) {
+        return false;
+    }
+    try {
+        input.value = std::stoll(value);
+    } catch (const std::out_of_range&) {
+        return false;
+    }
+    return true;
+}
 
 /**
  * Main entry point for the LiteScript interpreter/compiler.
- * This program accepts a source file and an action (interpret or compile) via command-line arguments.
- * It either interprets the file (runs it) or compiles it into an assembly file.
+ * This program accepts a source file and an action (interpret, compile, analyze or build) via command-line
+ * arguments. It either interprets the file (runs it), compiles it into a native executable, evaluates it
+ * symbolically, or compiles it into a bytecode file. The serve action instead runs scripts for clients of a
+ * local socket.
  *
- * Usage: ./litescript <action> <filename.ls>
+ * Usage: ./litescript <action> [options] <filename.ls>
  *
  * Actions:
  *   - interpret: Executes the source file directly
- *   - compile: Compiles the source file into an assembly file (output.asm)
+ *   - compile: Compiles the source file into a native executable (output), then runs it
+ *   - analyze: Prints the value of every show statement as a linear form over the script's inputs
+ *   - build: Compiles the source file into a bytecode file next to it (file.lsc), which interpret runs on the VM
+ *     without parsing it again
+ *   - serve: Runs scripts sent over a Unix domain socket until interrupted; takes no file
+ *     (./litescript serve --socket=PATH [--threads=N] [--cache-size=N] [--opt-level=N])
+ *
+ * Options:
+ *   - --engine=tree|vm|jit|parallel: Selects the engine used by interpret (default: tree)
+ *   - --jit: Same as --engine=jit, running the script as native code generated in memory
+ *   - --stream: Interprets statement by statement as the file is read, in constant memory (tree engine)
+ *   - --threads=N: Lexes and parses the file on N threads, and lets the tree engine sum very large expressions
+ *     on N threads (default: 1)
+ *   - --opt-level=N: Selects the optimization passes run before execution or compilation, 0 to 2 (default: 2)
+ *   - --emit-asm: Also writes the compiled program's NASM assembly (output.asm)
+ *   - --no-cache: Compiles even if the build cache holds an executable for the same script and options
+ *   - --flush-every=N: Writes interpreted output after every N shown values instead of in large blocks
+ *   - --background-output: Writes interpreted output from a background thread
+ *   - --opt-report: Reports on stderr how many IR instructions value numbering removed
+ *   - --emit-ir: Prints the program's optimized SSA intermediate representation instead of running it
+ *   - --input=NAME[=VALUE]: Declares a variable the script reads without assigning it, optionally bound to a
+ *     value (analyze only)
+ *   - --socket=PATH (or --socket PATH): The Unix domain socket to listen on (serve only)
+ *   - --cache-size=N: The number of compiled scripts the server keeps (serve only, default: 64)
  */
 int main(const int argc, char* argv[]) {
     LiteScript lite_script; // Create an instance of LiteScript to manage script execution.
 
     // Check for correct number of command-line arguments
-    if (argc != 3) {
-        std::cerr << "Usage: ./litescript <action> <filename.ls>\n";
-        std::cerr << "Actions: interpret, compile\n";
+    if (argc < 3) {
+        std::cerr << "Usage: ./litescript <action> [options] <filename.ls>\n";
+        std::cerr << "       ./litescript serve --socket=PATH [--threads=N] [--cache-size=N] [--opt-level=N]\n";
+        std::cerr << "Actions: interpret, compile, analyze, build, serve\n";
+        std::cerr << "Options: --engine=tree|vm|jit|parallel, --jit, --stream, --threads=N, --opt-level=N, --flush-every=N,\n";
+        std::cerr << "         --background-output, --opt-report, --emit-asm, --emit-ir, --no-cache,\n";
+        std::cerr << "         --input=NAME[=VALUE]\n";
         return EXIT_FAILURE;
     }
-    // Retrieve the action from the first argument
+    // Retrieve the action from the first argument and the script from the last; serve takes no script
     const std::string action = argv[1];
+    const bool serving = action == "serve";
+    const int optionEnd = serving ? argc : argc - 1;
+    const std::string filename = serving ? "" : argv[argc - 1];
+    Engine engine = Engine::TREE;
+    bool engineSet = false;
+    bool stream = false;
+    unsigned threads = 1;
+    bool threadsSet = false;
+    bool emitAsm = false;
+    bool emitIR = false;
+    bool useCache = true;
+    bool optReport = false;
+    std::vector<InputBinding> inputs;
+    OutputOptions outputOptions;
+    int optLevel = Optimizer::MAX_LEVEL;
+    bool optLevelSet = false;
+    ServerOptions serverOptions;
+    bool cacheSizeSet = false;
+
+    // Parse the options between the action and the script
+    for (int i = 2; i < optionEnd; ++i) {
+        const std::string option = argv[i];
+
+        if (option == "--engine=tree") {
+            engine = Engine::TREE;
+            engineSet = true;
+        } else if (option == "--engine=vm") {
+            engine = Engine::VM;
+            engineSet = true;
+        } else if (option == "--engine=parallel") {
+            engine = Engine::PARALLEL;
+            engineSet = true;
+        } else if (option == "--engine=jit" || option == "--jit") {
+            engine = Engine::JIT;
+            engineSet = true;
+        } else if (option == "--stream") {
+            stream = true;
+        } else if (option == "--emit-asm") {
+            emitAsm = true;
+        } else if (option == "--no-cache") {
+            useCache = false;
+        } else if (option.rfind("--flush-every=", 0) == 0 && option.size() > 14
+                   && option.find_first_not_of("0123456789", 14) == std::string::npos) {
+            outputOptions.flushEvery = static_cast<std::size_t>(std::stoull(option.substr(14)));
+        } else if (option == "--background-output") {
+            outputOptions.background = true;
+        } else if (option == "--opt-report") {
+            optReport = true;
+        } else if (option.rfind("--input=", 0) == 0) {
+            InputBinding input;
+            if (!parseInput(option.substr(8), input)) {
+                std::cerr << "Invalid input: " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+            for (const InputBinding& declared : inputs) {
+                if (declared.name == input.name) {
+                    std::cerr << "Input declared twice: " << input.name << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+            inputs.push_back(std::move(input));
+        } else if (option.rfind("--socket=", 0) == 0) {
+            serverOptions.socketPath = option.substr(9);
+        } else if (option == "--socket" && i + 1 < optionEnd) {
+            serverOptions.socketPath = argv[++i];
+        } else if (option.rfind("--cache-size=", 0) == 0 && option.size() > 13
+                   && option.find_first_not_of("0123456789", 13) == std::string::npos) {
+            serverOptions.cacheSize = static_cast<std::size_t>(std::stoull(option.substr(13)));
+            cacheSizeSet = true;
+        } else if (option == "--emit-ir") {
+            emitIR = true;
+        } else if (option.rfind("--threads=", 0) == 0 && option.size() > 10
+                   && option.find_first_not_of("0123456789", 10) == std::string::npos) {
+            threads = static_cast<unsigned>(std::stoul(option.substr(10)));
+            threadsSet = true;
+        } else if (option.rfind("--opt-level=", 0) == 0 && option.size() == 13
+                   && option[12] >= '0' && option[12] <= '0' + Optimizer::MAX_LEVEL) {
+            optLevel = option[12] - '0';
+            optLevelSet = true;
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (serving && (stream || engineSet || emitAsm || emitIR || optReport || !useCache || !inputs.empty()
+                    || outputOptions.flushEvery != 0 || outputOptions.background)) {
+        std::cerr << "serve only supports --socket, --threads, --cache-size and --opt-level" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (serving && serverOptions.socketPath.empty()) {
+        std::cerr << "serve needs --socket=PATH" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!serving && (!serverOptions.socketPath.empty() || cacheSizeSet)) {
+        std::cerr << "--socket and --cache-size are only supported by serve" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Bytecode files hold a program that was optimized when it was built, in the form only the VM runs
+    const bool bytecodeFile = std::filesystem::path(filename).extension() == ".lsc";
+    if (bytecodeFile && action != "interpret") {
+        std::cerr << "Bytecode files (.lsc) can only be interpreted" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (bytecodeFile && engineSet && engine != Engine::VM) {
+        std::cerr << "Bytecode files (.lsc) run on the vm engine" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (bytecodeFile && (stream || optLevelSet || optReport || emitIR)) {
+        std::cerr << "--stream, --opt-level, --opt-report and --emit-ir need a source file, not bytecode" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (stream && (action != "interpret" || engine != Engine::TREE)) {
+        std::cerr << "--stream is only supported by interpret with the tree engine" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (stream && optLevelSet) {
+        std::cerr << "--opt-level is not supported with --stream, which runs each statement unoptimized" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (stream && optReport) {
+        std::cerr << "--opt-report is not supported with --stream, which runs each statement unoptimized" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (stream && emitIR) {
+        std::cerr << "--emit-ir is not supported with --stream, which never builds the IR" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if ((outputOptions.flushEvery != 0 || outputOptions.background) && action != "interpret") {
+        std::cerr << "--flush-every and --background-output are only supported by interpret" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!inputs.empty() && action != "analyze") {
+        std::cerr << "--input is only supported by analyze" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (emitAsm && action != "compile") {
+        std::cerr << "--emit-asm is only supported by compile" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!useCache && action != "compile") {
+        std::cerr << "--no-cache is only supported by compile" << std::endl;
+        return EXIT_FAILURE;
+    }
 
     if (action == "interpret") {
         // Interpret and execute the script
+        lite_script.setOutputOptions(outputOptions);
         try {
-            lite_script.loadFile(argv[2]);  // Load and process the specified script file
-            lite_script.interpret();        // Interpret and execute the loaded commands
+            if (bytecodeFile) {
+                lite_script.interpretBytecodeFile(filename);  // Run the mapped bytecode on the VM
+            } else if (stream) {
+                lite_script.streamFile(filename);  // Run each statement as soon as it is parsed
+            } else {
+                lite_script.loadFile(filename, threads, optLevel);  // Load, optimize and lower the script
+                if (optReport) {
+                    reportOptimization(lite_script);
+                }
+                if (emitIR) {
+                    lite_script.dumpIR(std::cout);  // Show the optimized IR instead of running it
+                } else {
+                    lite_script.interpret(engine, threads);  // Interpret and execute the loaded commands
+                }
+            }
         } catch (const std::exception& e) {
             std::cerr << "Error: " << e.what() << std::endl;
             return EXIT_FAILURE;
         }
     } else if (action == "compile") {
-        // Compile the script into an assembly file
+        // Compile the script into a native executable
+        try {
+            if (optReport || emitIR) {
+                lite_script.loadFile(filename, threads, optLevel);  // Load, optimize and lower the script
+                if (optReport) {
+                    reportOptimization(lite_script);
+                }
+                if (emitIR) {
+                    lite_script.dumpIR(std::cout);  // Show the optimized IR instead of compiling it
+                } else {
+                    lite_script.compile("output", emitAsm);  // Compile to an executable named output
+                }
+            } else {
+                // Reuse the executable built for the same source and options when the cache has one
+                const std::filesystem::path cacheDirectory = useCache ? BuildCache::defaultDirectory()
+                                                                      : std::filesystem::path();
+                const BuildCache cache(cacheDirectory);
+                lite_script.compileFile(filename, "output", threads, optLevel, emitAsm,
+                                        cacheDirectory.empty() ? nullptr : &cache);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else if (action == "analyze") {
+        // Evaluate the script symbolically over its inputs
+        try {
+            lite_script.setInputs(std::move(inputs));
+            lite_script.loadFile(filename, threads, optLevel);  // Load, optimize and lower the script
+            if (optReport) {
+                reportOptimization(lite_script);
+            }
+            if (emitIR) {
+                lite_script.dumpIR(std::cout);  // Show the optimized IR instead of analyzing it
+            } else {
+                lite_script.analyze(std::cout);  // Print each shown value in closed form
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else if (action == "build") {
+        // Compile the script into a bytecode file next to it
+        try {
+            lite_script.loadFile(filename, threads, optLevel);  // Load, optimize and lower the script
+            if (optReport) {
+                reportOptimization(lite_script);
+            }
+            if (emitIR) {
+                lite_script.dumpIR(std::cout);  // Show the optimized IR instead of building it
+            } else {
+                lite_script.build(std::filesystem::path(filename).replace_extension(".lsc").string());
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else if (serving) {
+        // Run scripts for clients of the socket until interrupted
+        serverOptions.threads = threadsSet ? threads : 0;
+        serverOptions.optLevel = optLevel;
         try {
-            lite_script.loadFile(argv[2]);       // Load and process the specified script file
-            lite_script.compile("output.asm");    // Compile to an assembly file named output.asm
+            ScriptServer server(serverOptions);
+            server.serve();
         } catch (const std::exception& e) {
             std::cerr << "Error: " << e.what() << std::endl;
             return EXIT_FAILURE;